@@ -7,6 +7,7 @@
 #ifndef OD_LUOS_OD_H_
 #define OD_LUOS_OD_H_
 
+#include "od_value.h"
 #include "od_linear.h"
 #include "od_angular.h"
 #include "od_force.h"
@@ -27,5 +28,44 @@
 /*******************************************************************************
  * Function
  ******************************************************************************/
+/******************************************************************************
+ * @brief get the int24 encoding resolution of the value carried by a command
+ * @param cmd of the message
+ * @return frac_bits of the value type, 0 if the type has no int24 encoding
+ ******************************************************************************/
+static inline uint8_t OD_GetFracBits(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case LINEAR_POSITION:
+            return LINEAR_POSITION_FRAC_BITS;
+        case LINEAR_SPEED:
+            return LINEAR_SPEED_FRAC_BITS;
+        case ANGULAR_POSITION:
+            return ANGULAR_POSITION_FRAC_BITS;
+        case ANGULAR_SPEED:
+            return ANGULAR_SPEED_FRAC_BITS;
+        case VOLTAGE:
+            return VOLTAGE_FRAC_BITS;
+        case CURRENT:
+            return CURRENT_FRAC_BITS;
+        case POWER:
+            return POWER_FRAC_BITS;
+        case MOMENT:
+            return MOMENT_FRAC_BITS;
+        case FORCE:
+            return FORCE_FRAC_BITS;
+        case RATIO:
+            return RATIO_FRAC_BITS;
+        case TEMPERATURE:
+            return TEMPERATURE_FRAC_BITS;
+        case ILLUMINANCE:
+            return ILLUMINANCE_FRAC_BITS;
+        case TIME:
+            return TIME_FRAC_BITS;
+        default:
+            return 0;
+    }
+}
 
 #endif /* OD_LUOS_OD_H_ */
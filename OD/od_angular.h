@@ -10,7 +10,9 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float angular_position_t;
+typedef od_value_t angular_position_t;
+
+#define ANGULAR_POSITION_FRAC_BITS 8 // int24 encoding with 0.004 deg resolution and +/-32768 deg range
 
 /*******************************************************************************
  * Variables
@@ -23,111 +25,225 @@ typedef float angular_position_t;
 //******** Conversions ***********
 
 // deg
-static inline float AngularOD_PositionTo_deg(angular_position_t self)
+static inline od_value_t AngularOD_PositionTo_deg(angular_position_t self)
 {
     return self;
 }
 
-static inline angular_position_t AngularOD_PositionFrom_deg(float deg)
+static inline angular_position_t AngularOD_PositionFrom_deg(od_value_t deg)
 {
     return deg;
 }
 
 // rev
-static inline float AngularOD_PositionTo_rev(angular_position_t self)
+static inline od_value_t AngularOD_PositionTo_rev(angular_position_t self)
 {
-    return self / 360.0f;
+    return OD_DIV(self, 360.0f);
 }
 
-static inline angular_position_t AngularOD_PositionFrom_rev(float rev)
+static inline angular_position_t AngularOD_PositionFrom_rev(od_value_t rev)
 {
-    return rev * 360.0f;
+    return OD_MUL(rev, 360.0f);
 }
 
 // rad
-static inline float AngularOD_PositionTo_rad(angular_position_t self)
+static inline od_value_t AngularOD_PositionTo_rad(angular_position_t self)
+{
+    return OD_MULDIV(self, 2.0f * 3.141592653589793f, 360.0f);
+}
+
+static inline angular_position_t AngularOD_PositionFrom_rad(od_value_t rad)
+{
+    return OD_MULDIV(rad, 360.0f, 2.0f * 3.141592653589793f);
+}
+
+//******** Array conversions ***********
+static inline void AngularOD_PositionTo_deg_array(od_value_t *__restrict dst, const angular_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void AngularOD_PositionFrom_deg_array(angular_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void AngularOD_PositionTo_rev_array(od_value_t *__restrict dst, const angular_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 360.0f);
+    }
+}
+
+static inline void AngularOD_PositionFrom_rev_array(angular_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return (self * 2.0f * 3.141592653589793f) / 360.0f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 360.0f);
+    }
 }
 
-static inline angular_position_t AngularOD_PositionFrom_rad(float rad)
+static inline void AngularOD_PositionTo_rad_array(od_value_t *__restrict dst, const angular_position_t *__restrict src, uint16_t n)
 {
-    return (rad * 360.0f) / (2.0f * 3.141592653589793f);
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 2.0f * 3.141592653589793f / 360.0f);
+    }
+}
+
+static inline void AngularOD_PositionFrom_rad_array(angular_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 360.0f / (2.0f * 3.141592653589793f));
+    }
 }
 
 //******** Messages management ***********
 static inline void AngularOD_PositionToMsg(const angular_position_t *const self, msg_t *const msg)
 {
     msg->header.cmd = ANGULAR_POSITION;
-    memcpy(msg->data, self, sizeof(angular_position_t));
-    msg->header.size = sizeof(angular_position_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, ANGULAR_POSITION_FRAC_BITS);
 }
 
 static inline void AngularOD_PositionFromMsg(angular_position_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, ANGULAR_POSITION_FRAC_BITS);
 }
 
-typedef float angular_speed_t;
+typedef od_value_t angular_speed_t;
+
+#define ANGULAR_SPEED_FRAC_BITS 8 // int24 encoding with 0.004 deg/s resolution and +/-32768 deg/s range
 
 // angular_speed are stored in degree/s (deg/s)
 //******** Conversions ***********
 
 // deg_s
-static inline float AngularOD_SpeedTo_deg_s(angular_speed_t self)
+static inline od_value_t AngularOD_SpeedTo_deg_s(angular_speed_t self)
 {
     return self;
 }
 
-static inline angular_speed_t AngularOD_SpeedFrom_deg_s(float deg)
+static inline angular_speed_t AngularOD_SpeedFrom_deg_s(od_value_t deg)
 {
     return deg;
 }
 
 // rev_s
-static inline float AngularOD_SpeedTo_rev_s(angular_speed_t self)
+static inline od_value_t AngularOD_SpeedTo_rev_s(angular_speed_t self)
 {
-    return self / 360.0f;
+    return OD_DIV(self, 360.0f);
 }
 
-static inline angular_speed_t AngularOD_SpeedFrom_rev_s(float rev_s)
+static inline angular_speed_t AngularOD_SpeedFrom_rev_s(od_value_t rev_s)
 {
-    return rev_s * 360.0f;
+    return OD_MUL(rev_s, 360.0f);
 }
 
 // rev_min
-static inline float AngularOD_SpeedTo_rev_min(angular_speed_t self)
+static inline od_value_t AngularOD_SpeedTo_rev_min(angular_speed_t self)
 {
-    return self * 60.0f / 360.0f;
+    return OD_MULDIV(self, 60.0f, 360.0f);
 }
 
-static inline angular_speed_t AngularOD_SpeedFrom_rev_min(float rev_min)
+static inline angular_speed_t AngularOD_SpeedFrom_rev_min(od_value_t rev_min)
 {
-    return rev_min * 360.0f / 60.0f;
+    return OD_MULDIV(rev_min, 360.0f, 60.0f);
 }
 
 // rad_s
-static inline float AngularOD_SpeedTo_rad_s(angular_speed_t self)
+static inline od_value_t AngularOD_SpeedTo_rad_s(angular_speed_t self)
+{
+    return OD_MULDIV(self, 2.0f * 3.141592653589793f, 360.0f);
+}
+
+static inline angular_speed_t AngularOD_SpeedFrom_rad_s(od_value_t rad_s)
+{
+    return OD_MULDIV(rad_s, 360.0f, 2.0f * 3.141592653589793f);
+}
+
+//******** Array conversions ***********
+static inline void AngularOD_SpeedTo_deg_s_array(od_value_t *__restrict dst, const angular_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void AngularOD_SpeedFrom_deg_s_array(angular_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void AngularOD_SpeedTo_rev_s_array(od_value_t *__restrict dst, const angular_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 360.0f);
+    }
+}
+
+static inline void AngularOD_SpeedFrom_rev_s_array(angular_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 360.0f);
+    }
+}
+
+static inline void AngularOD_SpeedTo_rev_min_array(od_value_t *__restrict dst, const angular_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 60.0f / 360.0f);
+    }
+}
+
+static inline void AngularOD_SpeedFrom_rev_min_array(angular_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 360.0f / 60.0f);
+    }
+}
+
+static inline void AngularOD_SpeedTo_rad_s_array(od_value_t *__restrict dst, const angular_speed_t *__restrict src, uint16_t n)
 {
-    return (self * 2.0f * 3.141592653589793f) / 360.0f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 2.0f * 3.141592653589793f / 360.0f);
+    }
 }
 
-static inline angular_speed_t AngularOD_SpeedFrom_rad_s(float rad_s)
+static inline void AngularOD_SpeedFrom_rad_s_array(angular_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return (rad_s * 360.0f) / (2.0f * 3.141592653589793f);
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 360.0f / (2.0f * 3.141592653589793f));
+    }
 }
 
 //******** Messages management ***********
 static inline void AngularOD_SpeedToMsg(const angular_speed_t *const self, msg_t *const msg)
 {
     msg->header.cmd = ANGULAR_SPEED;
-    memcpy(msg->data, self, sizeof(angular_speed_t));
-    msg->header.size = sizeof(angular_speed_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, ANGULAR_SPEED_FRAC_BITS);
 }
 
 static inline void AngularOD_SpeedFromMsg(angular_speed_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, ANGULAR_SPEED_FRAC_BITS);
 }
 
 #endif /* OD_OD_ANGULAR_H_ */
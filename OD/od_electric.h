@@ -10,7 +10,10 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float voltage_t;
+typedef od_value_t voltage_t;
+
+#define VOLTAGE_FRAC_BITS 16 // int24 encoding with 15 uV resolution and +/-128 V range
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -22,118 +25,218 @@ typedef float voltage_t;
 //******** Conversions ***********
 
 // mv
-static inline float ElectricOD_VoltageTo_mV(voltage_t self)
+static inline od_value_t ElectricOD_VoltageTo_mV(voltage_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline voltage_t ElectricOD_VoltageFrom_mV(float mv)
+static inline voltage_t ElectricOD_VoltageFrom_mV(od_value_t mv)
 {
-    return mv / 1000.0f;
+    return OD_DIV(mv, 1000.0f);
 }
 
 // v
-static inline float ElectricOD_VoltageTo_V(voltage_t self)
+static inline od_value_t ElectricOD_VoltageTo_V(voltage_t self)
 {
     return self;
 }
 
-static inline voltage_t ElectricOD_VoltageFrom_V(float v)
+static inline voltage_t ElectricOD_VoltageFrom_V(od_value_t v)
 {
     return v;
 }
 
+//******** Array conversions ***********
+static inline void ElectricOD_VoltageTo_mV_array(od_value_t *__restrict dst, const voltage_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void ElectricOD_VoltageFrom_mV_array(voltage_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void ElectricOD_VoltageTo_V_array(od_value_t *__restrict dst, const voltage_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ElectricOD_VoltageFrom_V_array(voltage_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
 //******** Messages management ***********
 static inline void ElectricOD_VoltageToMsg(const voltage_t *const self, msg_t *const msg)
 {
     msg->header.cmd = VOLTAGE;
-    memcpy(msg->data, self, sizeof(voltage_t));
-    msg->header.size = sizeof(voltage_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, VOLTAGE_FRAC_BITS);
 }
 
 static inline void ElectricOD_VoltageFromMsg(voltage_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, VOLTAGE_FRAC_BITS);
 }
 
-typedef float current_t;
+typedef od_value_t current_t;
+
+#define CURRENT_FRAC_BITS 16 // int24 encoding with 15 uA resolution and +/-128 A range
 
 // current are stored in Ampere (A)
 //******** Conversions ***********
 
 // ma
-static inline float ElectricOD_CurrentTo_mA(current_t self)
+static inline od_value_t ElectricOD_CurrentTo_mA(current_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline current_t ElectricOD_CurrentFrom_mA(float ma)
+static inline current_t ElectricOD_CurrentFrom_mA(od_value_t ma)
 {
-    return ma / 1000.0f;
+    return OD_DIV(ma, 1000.0f);
 }
 
 // A
-static inline float ElectricOD_CurrentTo_A(current_t self)
+static inline od_value_t ElectricOD_CurrentTo_A(current_t self)
 {
     return self;
 }
 
-static inline current_t ElectricOD_CurrentFrom_A(float a)
+static inline current_t ElectricOD_CurrentFrom_A(od_value_t a)
 {
     return a;
 }
 
+//******** Array conversions ***********
+static inline void ElectricOD_CurrentTo_mA_array(od_value_t *__restrict dst, const current_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void ElectricOD_CurrentFrom_mA_array(current_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void ElectricOD_CurrentTo_A_array(od_value_t *__restrict dst, const current_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ElectricOD_CurrentFrom_A_array(current_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
 //******** Messages management ***********
 static inline void ElectricOD_CurrentToMsg(const current_t *const self, msg_t *const msg)
 {
     msg->header.cmd = CURRENT;
-    memcpy(msg->data, self, sizeof(current_t));
-    msg->header.size = sizeof(current_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, CURRENT_FRAC_BITS);
 }
 
 static inline void ElectricOD_CurrentFromMsg(current_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, CURRENT_FRAC_BITS);
 }
 
-typedef float power_t;
+typedef od_value_t power_t;
+
+#define POWER_FRAC_BITS 8 // int24 encoding with 4 mW resolution and +/-32768 W range
 
 // power are stored in Watt (W)
 //******** Conversions ***********
 
 // mw
-static inline float ElectricOD_PowerTo_mW(power_t self)
+static inline od_value_t ElectricOD_PowerTo_mW(power_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline power_t ElectricOD_PowerFrom_mW(float mw)
+static inline power_t ElectricOD_PowerFrom_mW(od_value_t mw)
 {
-    return mw / 1000.0f;
+    return OD_DIV(mw, 1000.0f);
 }
 
 // A
-static inline float ElectricOD_PowerTo_W(power_t self)
+static inline od_value_t ElectricOD_PowerTo_W(power_t self)
 {
     return self;
 }
 
-static inline power_t ElectricOD_PowerFrom_W(float w)
+static inline power_t ElectricOD_PowerFrom_W(od_value_t w)
 {
     return w;
 }
 
+//******** Array conversions ***********
+static inline void ElectricOD_PowerTo_mW_array(od_value_t *__restrict dst, const power_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void ElectricOD_PowerFrom_mW_array(power_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void ElectricOD_PowerTo_W_array(od_value_t *__restrict dst, const power_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ElectricOD_PowerFrom_W_array(power_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
 //******** Messages management ***********
 static inline void ElectricOD_PowerToMsg(const power_t *const self, msg_t *const msg)
 {
     msg->header.cmd = POWER;
-    memcpy(msg->data, self, sizeof(power_t));
-    msg->header.size = sizeof(power_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, POWER_FRAC_BITS);
 }
 
 static inline void ElectricOD_PowerFromMsg(current_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, POWER_FRAC_BITS);
 }
 
 #endif /* OD_OD_ELECTRIC_H_ */
@@ -10,7 +10,10 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float moment_t;
+typedef od_value_t moment_t;
+
+#define MOMENT_FRAC_BITS 16 // int24 encoding with 15 uNm resolution and +/-128 Nm range
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -23,166 +26,360 @@ typedef float moment_t;
 //******** Conversions ***********
 
 // N.mm
-static inline float ForceOD_MomentTo_N_mm(moment_t self)
+static inline od_value_t ForceOD_MomentTo_N_mm(moment_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline moment_t ForceOD_MomentFrom_N_mm(float n_mm)
+static inline moment_t ForceOD_MomentFrom_N_mm(od_value_t n_mm)
 {
-    return n_mm / 1000.0f;
+    return OD_DIV(n_mm, 1000.0f);
 }
 
 // N.cm
-static inline float ForceOD_MomentTo_N_cm(moment_t self)
+static inline od_value_t ForceOD_MomentTo_N_cm(moment_t self)
 {
-    return self * 100.0f;
+    return OD_MUL(self, 100.0f);
 }
 
-static inline moment_t ForceOD_MomentFrom_N_cm(float n_cm)
+static inline moment_t ForceOD_MomentFrom_N_cm(od_value_t n_cm)
 {
-    return n_cm / 100.0f;
+    return OD_DIV(n_cm, 100.0f);
 }
 
 // N.m
-static inline float ForceOD_MomentTo_N_m(moment_t self)
+static inline od_value_t ForceOD_MomentTo_N_m(moment_t self)
 {
     return self;
 }
 
-static inline moment_t ForceOD_MomentFrom_N_m(float n_m)
+static inline moment_t ForceOD_MomentFrom_N_m(od_value_t n_m)
 {
     return n_m;
 }
 
 // kgf.mm
-static inline float ForceOD_MomentTo_kgf_mm(moment_t self)
+static inline od_value_t ForceOD_MomentTo_kgf_mm(moment_t self)
 {
-    return self * 101.97f;
+    return OD_MUL(self, 101.97f);
 }
 
-static inline moment_t ForceOD_MomentFrom_kgf_mm(float kgf_mm)
+static inline moment_t ForceOD_MomentFrom_kgf_mm(od_value_t kgf_mm)
 {
-    return kgf_mm / 101.97f;
+    return OD_DIV(kgf_mm, 101.97f);
 }
 
 // kgf.cm
-static inline float ForceOD_MomentTo_kgf_cm(moment_t self)
+static inline od_value_t ForceOD_MomentTo_kgf_cm(moment_t self)
 {
-    return self * 10.2f;
+    return OD_MUL(self, 10.2f);
 }
 
-static inline moment_t ForceOD_MomentFrom_kgf_cm(float kgf_cm)
+static inline moment_t ForceOD_MomentFrom_kgf_cm(od_value_t kgf_cm)
 {
-    return kgf_cm / 10.2f;
+    return OD_DIV(kgf_cm, 10.2f);
 }
 
 // kgf.m
-static inline float ForceOD_MomentTo_kgf_m(moment_t self)
+static inline od_value_t ForceOD_MomentTo_kgf_m(moment_t self)
 {
-    return self * 0.102f;
+    return OD_MUL(self, 0.102f);
 }
 
-static inline moment_t ForceOD_MomentFrom_kgf_m(float kgf_m)
+static inline moment_t ForceOD_MomentFrom_kgf_m(od_value_t kgf_m)
 {
-    return kgf_m / 0.102f;
+    return OD_DIV(kgf_m, 0.102f);
 }
 
 // ozf.in
-static inline float ForceOD_MomentTo_ozf_in(moment_t self)
+static inline od_value_t ForceOD_MomentTo_ozf_in(moment_t self)
 {
-    return self * 141.612f;
+    return OD_MUL(self, 141.612f);
 }
 
-static inline moment_t ForceOD_MomentFrom_ozf_in(float ozf_in)
+static inline moment_t ForceOD_MomentFrom_ozf_in(od_value_t ozf_in)
 {
-    return ozf_in / 141.612f;
+    return OD_DIV(ozf_in, 141.612f);
 }
 
 // lbf.in
-static inline float ForceOD_MomentTo_lbf_in(moment_t self)
+static inline od_value_t ForceOD_MomentTo_lbf_in(moment_t self)
+{
+    return OD_MUL(self, 8.851f);
+}
+
+static inline moment_t ForceOD_MomentFrom_lbf_in(od_value_t lbf_in)
+{
+    return OD_DIV(lbf_in, 8.851f);
+}
+
+//******** Array conversions ***********
+static inline void ForceOD_MomentTo_N_mm_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void ForceOD_MomentFrom_N_mm_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void ForceOD_MomentTo_N_cm_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 100.0f);
+    }
+}
+
+static inline void ForceOD_MomentFrom_N_cm_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 100.0f);
+    }
+}
+
+static inline void ForceOD_MomentTo_N_m_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ForceOD_MomentFrom_N_m_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ForceOD_MomentTo_kgf_mm_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 101.97f);
+    }
+}
+
+static inline void ForceOD_MomentFrom_kgf_mm_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 101.97f);
+    }
+}
+
+static inline void ForceOD_MomentTo_kgf_cm_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 10.2f);
+    }
+}
+
+static inline void ForceOD_MomentFrom_kgf_cm_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 10.2f);
+    }
+}
+
+static inline void ForceOD_MomentTo_kgf_m_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
 {
-    return self * 8.851f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 0.102f);
+    }
 }
 
-static inline moment_t ForceOD_MomentFrom_lbf_in(float lbf_in)
+static inline void ForceOD_MomentFrom_kgf_m_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return lbf_in / 8.851f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 0.102f);
+    }
+}
+
+static inline void ForceOD_MomentTo_ozf_in_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 141.612f);
+    }
+}
+
+static inline void ForceOD_MomentFrom_ozf_in_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 141.612f);
+    }
+}
+
+static inline void ForceOD_MomentTo_lbf_in_array(od_value_t *__restrict dst, const moment_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 8.851f);
+    }
+}
+
+static inline void ForceOD_MomentFrom_lbf_in_array(moment_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 8.851f);
+    }
 }
 
 //******** Messages management ***********
 static inline void ForceOD_MomentToMsg(const moment_t *const self, msg_t *const msg)
 {
     msg->header.cmd = MOMENT;
-    memcpy(msg->data, self, sizeof(moment_t));
-    msg->header.size = sizeof(moment_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, MOMENT_FRAC_BITS);
 }
 
 static inline void ForceOD_MomentFromMsg(moment_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, MOMENT_FRAC_BITS);
 }
 
-typedef float force_t;
+typedef od_value_t force_t;
+
+#define FORCE_FRAC_BITS 12 // int24 encoding with 0.24 mN resolution and +/-2048 N range
 
 // force are stored in Newton (N)
 //******** Conversions ***********
 
 // N
-static inline float ForceOD_ForceTo_N(force_t self)
+static inline od_value_t ForceOD_ForceTo_N(force_t self)
 {
     return self;
 }
 
-static inline force_t ForceOD_ForceFrom_N(float n)
+static inline force_t ForceOD_ForceFrom_N(od_value_t n)
 {
     return n;
 }
 
 // kgf
-static inline float ForceOD_ForceTo_kgf(force_t self)
+static inline od_value_t ForceOD_ForceTo_kgf(force_t self)
 {
-    return self * 0.102f;
+    return OD_MUL(self, 0.102f);
 }
 
-static inline force_t ForceOD_ForceFrom_kgf(float kgf)
+static inline force_t ForceOD_ForceFrom_kgf(od_value_t kgf)
 {
-    return kgf / 0.102f;
+    return OD_DIV(kgf, 0.102f);
 }
 
 // ozf
-static inline float ForceOD_ForceTo_ozf(force_t self)
+static inline od_value_t ForceOD_ForceTo_ozf(force_t self)
 {
-    return self * 141.612f;
+    return OD_MUL(self, 141.612f);
 }
 
-static inline force_t ForceOD_ForceFrom_ozf(float ozf)
+static inline force_t ForceOD_ForceFrom_ozf(od_value_t ozf)
 {
-    return ozf / 141.612f;
+    return OD_DIV(ozf, 141.612f);
 }
 
 // lbf
-static inline float ForceOD_ForceTo_lbf(force_t self)
+static inline od_value_t ForceOD_ForceTo_lbf(force_t self)
+{
+    return OD_MUL(self, 8.851f);
+}
+
+static inline force_t ForceOD_ForceFrom_lbf(od_value_t lbf)
+{
+    return OD_DIV(lbf, 8.851f);
+}
+
+//******** Array conversions ***********
+static inline void ForceOD_ForceTo_N_array(od_value_t *__restrict dst, const force_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ForceOD_ForceFrom_N_array(force_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void ForceOD_ForceTo_kgf_array(od_value_t *__restrict dst, const force_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 0.102f);
+    }
+}
+
+static inline void ForceOD_ForceFrom_kgf_array(force_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 0.102f);
+    }
+}
+
+static inline void ForceOD_ForceTo_ozf_array(od_value_t *__restrict dst, const force_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 141.612f);
+    }
+}
+
+static inline void ForceOD_ForceFrom_ozf_array(force_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 141.612f);
+    }
+}
+
+static inline void ForceOD_ForceTo_lbf_array(od_value_t *__restrict dst, const force_t *__restrict src, uint16_t n)
 {
-    return self * 8.851f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 8.851f);
+    }
 }
 
-static inline force_t ForceOD_ForceFrom_lbf(float lbf)
+static inline void ForceOD_ForceFrom_lbf_array(force_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return lbf / 8.851f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 8.851f);
+    }
 }
 
 //******** Messages management ***********
 static inline void ForceOD_ForceToMsg(const force_t *const self, msg_t *const msg)
 {
     msg->header.cmd = FORCE;
-    memcpy(msg->data, self, sizeof(force_t));
-    msg->header.size = sizeof(force_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, FORCE_FRAC_BITS);
 }
 
 static inline void ForceOD_ForceFromMsg(force_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, FORCE_FRAC_BITS);
 }
 
 #endif /* OD_OD_FORCE_H_ */
@@ -10,7 +10,9 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float illuminance_t;
+typedef od_value_t illuminance_t;
+
+#define ILLUMINANCE_FRAC_BITS 4 // int24 encoding with 0.06 lx resolution and +/-524288 lx range
 
 /*******************************************************************************
  * Variables
@@ -23,27 +25,43 @@ typedef float illuminance_t;
 //******** Conversions ***********
 
 // lx
-static inline float IlluminanceOD_IlluminanceTo_Lux(illuminance_t self)
+static inline od_value_t IlluminanceOD_IlluminanceTo_Lux(illuminance_t self)
 {
     return self;
 }
 
-static inline illuminance_t IlluminanceOD_IlluminanceFrom_Lux(float lx)
+static inline illuminance_t IlluminanceOD_IlluminanceFrom_Lux(od_value_t lx)
 {
     return lx;
 }
 
+//******** Array conversions ***********
+static inline void IlluminanceOD_IlluminanceTo_Lux_array(od_value_t *__restrict dst, const illuminance_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void IlluminanceOD_IlluminanceFrom_Lux_array(illuminance_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
 //******** Messages management ***********
 static inline void IlluminanceOD_IlluminanceToMsg(const illuminance_t *const self, msg_t *const msg)
 {
     msg->header.cmd = ILLUMINANCE;
-    memcpy(msg->data, self, sizeof(illuminance_t));
-    msg->header.size = sizeof(illuminance_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, ILLUMINANCE_FRAC_BITS);
 }
 
 static inline void IlluminanceOD_IlluminanceFromMsg(illuminance_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, ILLUMINANCE_FRAC_BITS);
 }
 
 // GPIO struct
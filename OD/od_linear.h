@@ -13,7 +13,9 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float linear_position_t;
+typedef od_value_t linear_position_t;
+
+#define LINEAR_POSITION_FRAC_BITS 16 // int24 encoding with 15 um resolution and +/-128 m range
 
 /*******************************************************************************
  * Variables
@@ -26,187 +28,413 @@ typedef float linear_position_t;
 // linear_position are stored in meter (m)
 //******** Conversions ***********
 // nm
-static inline float LinearOD_PositionTo_nm(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_nm(linear_position_t self)
 {
-    return self * 1000000000.0f;
+    return OD_MUL(self, 1000000000.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_nm(float nm)
+static inline linear_position_t LinearOD_PositionFrom_nm(od_value_t nm)
 {
-    return nm / 1000000000.0f;
+    return OD_DIV(nm, 1000000000.0f);
 }
 
 // um
-static inline float LinearOD_PositionTo_um(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_um(linear_position_t self)
 {
-    return self * 1000000.0f;
+    return OD_MUL(self, 1000000.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_um(float um)
+static inline linear_position_t LinearOD_PositionFrom_um(od_value_t um)
 {
-    return um / 1000000.0f;
+    return OD_DIV(um, 1000000.0f);
 }
 
 // mm
-static inline float LinearOD_PositionTo_mm(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_mm(linear_position_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_mm(float mm)
+static inline linear_position_t LinearOD_PositionFrom_mm(od_value_t mm)
 {
-    return mm / 1000.0f;
+    return OD_DIV(mm, 1000.0f);
 }
 
 // cm
-static inline float LinearOD_PositionTo_cm(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_cm(linear_position_t self)
 {
-    return self * 100.0f;
+    return OD_MUL(self, 100.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_cm(float cm)
+static inline linear_position_t LinearOD_PositionFrom_cm(od_value_t cm)
 {
-    return cm / 100.0f;
+    return OD_DIV(cm, 100.0f);
 }
 
 // m
-static inline float LinearOD_PositionTo_m(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_m(linear_position_t self)
 {
     return self;
 }
 
-static inline linear_position_t LinearOD_PositionFrom_m(float m)
+static inline linear_position_t LinearOD_PositionFrom_m(od_value_t m)
 {
     return m;
 }
 
 // km
-static inline float LinearOD_PositionTo_km(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_km(linear_position_t self)
 {
-    return self / 1000.0f;
+    return OD_DIV(self, 1000.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_km(float km)
+static inline linear_position_t LinearOD_PositionFrom_km(od_value_t km)
 {
-    return km * 1000.0f;
+    return OD_MUL(km, 1000.0f);
 }
 
 // inch
-static inline float LinearOD_PositionTo_in(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_in(linear_position_t self)
 {
-    return self * 254.0f;
+    return OD_MUL(self, 254.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_in(float in)
+static inline linear_position_t LinearOD_PositionFrom_in(od_value_t in)
 {
-    return in / 254.0f;
+    return OD_DIV(in, 254.0f);
 }
 
 // foot
-static inline float LinearOD_PositionTo_ft(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_ft(linear_position_t self)
 {
-    return self * 3048.0f;
+    return OD_MUL(self, 3048.0f);
 }
 
-static inline linear_position_t LinearOD_PositionFrom_ft(float ft)
+static inline linear_position_t LinearOD_PositionFrom_ft(od_value_t ft)
 {
-    return ft / 3048.0f;
+    return OD_DIV(ft, 3048.0f);
 }
 
 // mile
-static inline float LinearOD_PositionTo_mi(linear_position_t self)
+static inline od_value_t LinearOD_PositionTo_mi(linear_position_t self)
+{
+    return OD_DIV(self, 1609.344f);
+}
+static inline linear_position_t LinearOD_PositionFrom_mi(od_value_t mi)
+{
+    return OD_MUL(mi, 1609.344f);
+}
+
+//******** Array conversions ***********
+static inline void LinearOD_PositionTo_nm_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000000000.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_nm_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000000000.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_um_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000000.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_um_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000000.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_mm_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_mm_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_cm_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 100.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_cm_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 100.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_m_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void LinearOD_PositionFrom_m_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void LinearOD_PositionTo_km_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_km_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_in_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 254.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_in_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 254.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_ft_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 3048.0f);
+    }
+}
+
+static inline void LinearOD_PositionFrom_ft_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 3048.0f);
+    }
+}
+
+static inline void LinearOD_PositionTo_mi_array(od_value_t *__restrict dst, const linear_position_t *__restrict src, uint16_t n)
 {
-    return self / 1609.344f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1609.344f);
+    }
 }
-static inline linear_position_t LinearOD_PositionFrom_mi(float mi)
+
+static inline void LinearOD_PositionFrom_mi_array(linear_position_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return mi * 1609.344f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1609.344f);
+    }
 }
 
 //******** Messages management ***********
 static inline void LinearOD_PositionToMsg(const linear_position_t *const self, msg_t *const msg)
 {
     msg->header.cmd = LINEAR_POSITION;
-    memcpy(msg->data, self, sizeof(linear_position_t));
-    msg->header.size = sizeof(linear_position_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, LINEAR_POSITION_FRAC_BITS);
 }
 
 static inline void LinearOD_PositionFromMsg(linear_position_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, LINEAR_POSITION_FRAC_BITS);
 }
 
-typedef float linear_speed_t;
+typedef od_value_t linear_speed_t;
+
+#define LINEAR_SPEED_FRAC_BITS 16 // int24 encoding with 15 um/s resolution and +/-128 m/s range
 
 // linear_speed are stored in meter per second (m_s)
 //******** Conversions ***********
 
 // mm_s
-static inline float LinearOD_SpeedTo_mm_s(linear_speed_t self)
+static inline od_value_t LinearOD_SpeedTo_mm_s(linear_speed_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline linear_speed_t LinearOD_Speedfrom_mm_s(float mm_s)
+static inline linear_speed_t LinearOD_Speedfrom_mm_s(od_value_t mm_s)
 {
-    return mm_s / 1000.0f;
+    return OD_DIV(mm_s, 1000.0f);
 }
 
 // m_s
-static inline float LinearOD_SpeedTo_m_s(linear_speed_t self)
+static inline od_value_t LinearOD_SpeedTo_m_s(linear_speed_t self)
 {
     return self;
 }
 
-static inline linear_speed_t LinearOD_Speedfrom_m_s(float m_s)
+static inline linear_speed_t LinearOD_Speedfrom_m_s(od_value_t m_s)
 {
     return m_s;
 }
 
 // km_h
-static inline float LinearOD_SpeedTo_km_h(linear_speed_t self)
+static inline od_value_t LinearOD_SpeedTo_km_h(linear_speed_t self)
 {
-    return (self * 3600.0f) / 1000.0f;
+    return OD_MULDIV(self, 3600.0f, 1000.0f);
 }
 
-static inline linear_speed_t LinearOD_SpeedFrom_km_h(float km_h)
+static inline linear_speed_t LinearOD_SpeedFrom_km_h(od_value_t km_h)
 {
-    return (km_h * 1000.0f) / 3600.0f;
+    return OD_MULDIV(km_h, 1000.0f, 3600.0f);
 }
 
 // in_s
-static inline float LinearOD_SpeedTo_in_s(linear_speed_t self)
+static inline od_value_t LinearOD_SpeedTo_in_s(linear_speed_t self)
 {
-    return (self * 3600.0f) / 254.0f;
+    return OD_MULDIV(self, 3600.0f, 254.0f);
 }
 
-static inline linear_speed_t LinearOD_SpeedFrom_in_s(float in_s)
+static inline linear_speed_t LinearOD_SpeedFrom_in_s(od_value_t in_s)
 {
-    return (in_s * 254.0f) / 3600.0f;
+    return OD_MULDIV(in_s, 254.0f, 3600.0f);
 }
 
 // mi_h
-static inline float LinearOD_SpeedTo_mi_h(linear_speed_t self)
+static inline od_value_t LinearOD_SpeedTo_mi_h(linear_speed_t self)
+{
+    return OD_MULDIV(self, 3600.0f, 254.0f);
+}
+
+static inline linear_speed_t LinearOD_SpeedFrom_mi_h(od_value_t mi_h)
+{
+    return OD_MULDIV(mi_h, 1609.344f, 3600.0f);
+}
+
+//******** Array conversions ***********
+static inline void LinearOD_SpeedTo_mm_s_array(od_value_t *__restrict dst, const linear_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void LinearOD_Speedfrom_mm_s_array(linear_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void LinearOD_SpeedTo_m_s_array(od_value_t *__restrict dst, const linear_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void LinearOD_Speedfrom_m_s_array(linear_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void LinearOD_SpeedTo_km_h_array(od_value_t *__restrict dst, const linear_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 3600.0f / 1000.0f);
+    }
+}
+
+static inline void LinearOD_SpeedFrom_km_h_array(linear_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f / 3600.0f);
+    }
+}
+
+static inline void LinearOD_SpeedTo_in_s_array(od_value_t *__restrict dst, const linear_speed_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 3600.0f / 254.0f);
+    }
+}
+
+static inline void LinearOD_SpeedFrom_in_s_array(linear_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 254.0f / 3600.0f);
+    }
+}
+
+static inline void LinearOD_SpeedTo_mi_h_array(od_value_t *__restrict dst, const linear_speed_t *__restrict src, uint16_t n)
 {
-    return (self * 3600.0f) / 254.0f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 3600.0f / 254.0f);
+    }
 }
 
-static inline linear_speed_t LinearOD_SpeedFrom_mi_h(float mi_h)
+static inline void LinearOD_SpeedFrom_mi_h_array(linear_speed_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return (mi_h * 1609.344f) / 3600.0f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1609.344f / 3600.0f);
+    }
 }
 
 //******** Messages management ***********
 static inline void LinearOD_SpeedToMsg(const linear_speed_t *const self, msg_t *const msg)
 {
     msg->header.cmd = LINEAR_SPEED;
-    memcpy(msg->data, self, sizeof(linear_speed_t));
-    msg->header.size = sizeof(linear_speed_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, LINEAR_SPEED_FRAC_BITS);
 }
 
 static inline void LinearOD_SpeedFromMsg(linear_speed_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, LINEAR_SPEED_FRAC_BITS);
 }
 
 #endif /* OD_OD_LINEAR_H_ */
@@ -10,7 +10,9 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float ratio_t;
+typedef od_value_t ratio_t;
+
+#define RATIO_FRAC_BITS 16 // int24 encoding with 15e-6 % resolution and +/-128 % range
 
 /*******************************************************************************
  * Variables
@@ -23,27 +25,43 @@ typedef float ratio_t;
 //******** Conversions ***********
 
 // percentage
-static inline float RatioOD_RatioToPercent(ratio_t self)
+static inline od_value_t RatioOD_RatioToPercent(ratio_t self)
 {
     return self;
 }
 
-static inline ratio_t RatioOD_RatioFromPercent(float percentage)
+static inline ratio_t RatioOD_RatioFromPercent(od_value_t percentage)
 {
     return percentage;
 }
 
+//******** Array conversions ***********
+static inline void RatioOD_RatioToPercent_array(od_value_t *__restrict dst, const ratio_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void RatioOD_RatioFromPercent_array(ratio_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
 //******** Messages management ***********
 static inline void RatioOD_RatioToMsg(const ratio_t *const self, msg_t *const msg)
 {
     msg->header.cmd = RATIO;
-    memcpy(msg->data, self, sizeof(ratio_t));
-    msg->header.size = sizeof(ratio_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, RATIO_FRAC_BITS);
 }
 
 static inline void RatioOD_RatioFromMsg(ratio_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, RATIO_FRAC_BITS);
 }
 
 #endif /* OD_OD_RATIO_H_ */
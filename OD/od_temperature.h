@@ -10,7 +10,9 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float temperature_t;
+typedef od_value_t temperature_t;
+
+#define TEMPERATURE_FRAC_BITS 12 // int24 encoding with 0.24 m°C resolution and +/-2048 °C range
 
 /*******************************************************************************
  * Variables
@@ -23,49 +25,97 @@ typedef float temperature_t;
 //******** Conversions ***********
 
 // °C
-static inline float TemperatureOD_TemperatureTo_deg_c(temperature_t self)
+static inline od_value_t TemperatureOD_TemperatureTo_deg_c(temperature_t self)
 {
     return self;
 }
 
-static inline temperature_t TemperatureOD_TemperatureFrom_deg_c(float deg_c)
+static inline temperature_t TemperatureOD_TemperatureFrom_deg_c(od_value_t deg_c)
 {
     return deg_c;
 }
 
 // °F
-static inline float TemperatureOD_TemperatureTo_deg_f(temperature_t self)
+static inline od_value_t TemperatureOD_TemperatureTo_deg_f(temperature_t self)
 {
-    return self * 1.8f + 32.0f;
+    return OD_ADD(OD_MUL(self, 1.8f), 32.0f);
 }
 
-static inline temperature_t TemperatureOD_TemperatureFrom_deg_f(float deg_f)
+static inline temperature_t TemperatureOD_TemperatureFrom_deg_f(od_value_t deg_f)
 {
-    return (deg_f - 32.0f) / 1.8f;
+    return OD_DIV(OD_ADD(deg_f, -32.0f), 1.8f);
 }
 
 // °K
-static inline float TemperatureOD_TemperatureTo_deg_k(temperature_t self)
+static inline od_value_t TemperatureOD_TemperatureTo_deg_k(temperature_t self)
+{
+    return OD_ADD(self, 273.15f);
+}
+
+static inline temperature_t TemperatureOD_TemperatureFrom_deg_k(od_value_t deg_k)
+{
+    return OD_ADD(deg_k, -273.15f);
+}
+
+//******** Array conversions ***********
+static inline void TemperatureOD_TemperatureTo_deg_c_array(od_value_t *__restrict dst, const temperature_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void TemperatureOD_TemperatureFrom_deg_c_array(temperature_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void TemperatureOD_TemperatureTo_deg_f_array(od_value_t *__restrict dst, const temperature_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_ADD(OD_MUL(src[i], 1.8f), 32.0f);
+    }
+}
+
+static inline void TemperatureOD_TemperatureFrom_deg_f_array(temperature_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(OD_ADD(src[i], -32.0f), 1.0f / 1.8f);
+    }
+}
+
+static inline void TemperatureOD_TemperatureTo_deg_k_array(od_value_t *__restrict dst, const temperature_t *__restrict src, uint16_t n)
 {
-    return self + 273.15f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_ADD(src[i], 273.15f);
+    }
 }
 
-static inline temperature_t TemperatureOD_TemperatureFrom_deg_k(float deg_k)
+static inline void TemperatureOD_TemperatureFrom_deg_k_array(temperature_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return deg_k - 273.15f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_ADD(src[i], -273.15f);
+    }
 }
 
 //******** Messages management ***********
 static inline void TemperatureOD_TemperatureToMsg(const temperature_t *const self, msg_t *const msg)
 {
     msg->header.cmd = TEMPERATURE;
-    memcpy(msg->data, self, sizeof(temperature_t));
-    msg->header.size = sizeof(temperature_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, TEMPERATURE_FRAC_BITS);
 }
 
 static inline void TemperatureOD_TemperatureFromMsg(temperature_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, TEMPERATURE_FRAC_BITS);
 }
 
 #endif /* OD_OD_TEMPERATURE_H_ */
@@ -10,7 +10,9 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-typedef float time_luos_t;
+typedef od_value_t time_luos_t;
+
+#define TIME_FRAC_BITS 16 // int24 encoding with 15 us resolution and +/-128 s range
 
 /*******************************************************************************
  * Variables
@@ -23,82 +25,178 @@ typedef float time_luos_t;
 //******** Conversions ***********
 
 // sec
-static inline float TimeOD_TimeTo_s(time_luos_t self)
+static inline od_value_t TimeOD_TimeTo_s(time_luos_t self)
 {
     return self;
 }
 
-static inline time_luos_t TimeOD_TimeFrom_s(float sec)
+static inline time_luos_t TimeOD_TimeFrom_s(od_value_t sec)
 {
     return sec;
 }
 
 // ms
-static inline float TimeOD_TimeTo_ms(time_luos_t self)
+static inline od_value_t TimeOD_TimeTo_ms(time_luos_t self)
 {
-    return self * 1000.0f;
+    return OD_MUL(self, 1000.0f);
 }
 
-static inline time_luos_t TimeOD_TimeFrom_ms(float ms)
+static inline time_luos_t TimeOD_TimeFrom_ms(od_value_t ms)
 {
-    return ms / 1000.0f;
+    return OD_DIV(ms, 1000.0f);
 }
 
 // µs
-static inline float TimeOD_TimeTo_us(time_luos_t self)
+static inline od_value_t TimeOD_TimeTo_us(time_luos_t self)
 {
-    return self * 1000000.0f;
+    return OD_MUL(self, 1000000.0f);
 }
 
-static inline time_luos_t TimeOD_TimeFrom_us(float us)
+static inline time_luos_t TimeOD_TimeFrom_us(od_value_t us)
 {
-    return us / 1000000.0f;
+    return OD_DIV(us, 1000000.0f);
 }
 
 // min
-static inline float TimeOD_TimeTo_min(time_luos_t self)
+static inline od_value_t TimeOD_TimeTo_min(time_luos_t self)
 {
-    return self / 60.0f;
+    return OD_DIV(self, 60.0f);
 }
 
-static inline time_luos_t TimeOD_TimeFrom_min(float min)
+static inline time_luos_t TimeOD_TimeFrom_min(od_value_t min)
 {
-    return min * 60.0f;
+    return OD_MUL(min, 60.0f);
 }
 
 // hour
-static inline float TimeOD_TimeTo_h(time_luos_t self)
+static inline od_value_t TimeOD_TimeTo_h(time_luos_t self)
 {
-    return self / 3600.0f;
+    return OD_DIV(self, 3600.0f);
 }
 
-static inline time_luos_t TimeOD_TimeFrom_h(float hour)
+static inline time_luos_t TimeOD_TimeFrom_h(od_value_t hour)
 {
-    return hour * 3600.0f;
+    return OD_MUL(hour, 3600.0f);
 }
 
 // day
-static inline float TimeOD_TimeTo_day(time_luos_t self)
+static inline od_value_t TimeOD_TimeTo_day(time_luos_t self)
+{
+    return OD_DIV(self, 86400.0f);
+}
+
+static inline time_luos_t TimeOD_TimeFrom_day(od_value_t day)
+{
+    return OD_MUL(day, 86400.0f);
+}
+
+//******** Array conversions ***********
+static inline void TimeOD_TimeTo_s_array(od_value_t *__restrict dst, const time_luos_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void TimeOD_TimeFrom_s_array(time_luos_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+static inline void TimeOD_TimeTo_ms_array(od_value_t *__restrict dst, const time_luos_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000.0f);
+    }
+}
+
+static inline void TimeOD_TimeFrom_ms_array(time_luos_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000.0f);
+    }
+}
+
+static inline void TimeOD_TimeTo_us_array(od_value_t *__restrict dst, const time_luos_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1000000.0f);
+    }
+}
+
+static inline void TimeOD_TimeFrom_us_array(time_luos_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 1000000.0f);
+    }
+}
+
+static inline void TimeOD_TimeTo_min_array(od_value_t *__restrict dst, const time_luos_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 60.0f);
+    }
+}
+
+static inline void TimeOD_TimeFrom_min_array(time_luos_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 60.0f);
+    }
+}
+
+static inline void TimeOD_TimeTo_h_array(od_value_t *__restrict dst, const time_luos_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 3600.0f);
+    }
+}
+
+static inline void TimeOD_TimeFrom_h_array(time_luos_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 3600.0f);
+    }
+}
+
+static inline void TimeOD_TimeTo_day_array(od_value_t *__restrict dst, const time_luos_t *__restrict src, uint16_t n)
 {
-    return self / 86400.0f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 1.0f / 86400.0f);
+    }
 }
 
-static inline time_luos_t TimeOD_TimeFrom_day(float day)
+static inline void TimeOD_TimeFrom_day_array(time_luos_t *__restrict dst, const od_value_t *__restrict src, uint16_t n)
 {
-    return day * 86400.0f;
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = OD_MUL(src[i], 86400.0f);
+    }
 }
 
 //******** Messages management ***********
 static inline void TimeOD_TimeToMsg(const time_luos_t *const self, msg_t *const msg)
 {
     msg->header.cmd = TIME;
-    memcpy(msg->data, self, sizeof(time_luos_t));
-    msg->header.size = sizeof(time_luos_t);
+    OD_ValueToMsg(msg, *self, OD_ENCODING, TIME_FRAC_BITS);
 }
 
 static inline void TimeOD_TimeFromMsg(time_luos_t *const self, const msg_t *const msg)
 {
-    memcpy(self, msg->data, msg->header.size);
+    OD_ValueFromMsg(self, msg, TIME_FRAC_BITS);
 }
 
 #endif /* OD_OD_TIME_H_ */
@@ -0,0 +1,461 @@
+/******************************************************************************
+ * @file OD_value
+ * @brief object dictionnary value representation
+ * @author Luos
+ * @version 0.0.0
+ ******************************************************************************/
+#ifndef OD_OD_VALUE_H_
+#define OD_OD_VALUE_H_
+
+#include "robus_struct.h"
+#include "string.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*
+ * By default OD values are float.
+ * Defining OD_FIXED_POINT turn them into Q16.16 fixed point values for MCUs without
+ * FPU. Conversions then only use integer operations, and the range of a value and of
+ * its conversions is limited to [-32768, 32768[ with a resolution of 1/65536, out of
+ * range conversions saturate.
+ *
+ * Whatever the representation, OD values are always sent as IEEE-754 float32 so
+ * float and fixed point nodes can share the same network without any negotiation.
+ */
+#ifdef OD_FIXED_POINT
+typedef int32_t od_value_t;
+
+#define OD_FIXED_FRAC_BITS 16
+
+// Convert a constant into a fixed point value at compile time
+#define OD_FIXED(value) ((od_value_t)((value) * (double)(1UL << OD_FIXED_FRAC_BITS) + (((value) < 0) ? -0.5 : 0.5)))
+// Multiply a fixed point value by a positive constant factor, big factors keep 16 bits of fraction and small ones 32
+#define OD_FIXED_SCALE(x, factor) \
+    OD_FixedSaturate(((factor) >= 1.0) ? (((int64_t)(x) * (int64_t)((factor) * 65536.0 + 0.5)) >> 16) \
+                                       : (((int64_t)(x) * (int64_t)((factor) * 4294967296.0 + 0.5)) >> 32))
+
+#define OD_MUL(x, factor)             OD_FIXED_SCALE(x, factor)
+#define OD_DIV(x, divisor)            OD_FIXED_SCALE(x, 1.0 / (divisor))
+#define OD_MULDIV(x, factor, divisor) OD_FIXED_SCALE(x, (double)(factor) / (double)(divisor))
+#define OD_ADD(x, offset)             ((x) + OD_FIXED(offset))
+#define OD_TO_INT(x)                  ((int32_t)(x) >> OD_FIXED_FRAC_BITS)
+#else
+typedef float od_value_t;
+
+#define OD_MUL(x, factor)             ((x) * (factor))
+#define OD_DIV(x, divisor)            ((x) / (divisor))
+#define OD_MULDIV(x, factor, divisor) (((x) * (factor)) / (divisor))
+#define OD_ADD(x, offset)             ((x) + (offset))
+#define OD_TO_INT(x)                  ((int32_t)(x))
+#endif
+
+/*
+ * A publisher can choose the encoding of the OD values it sends, the payload size
+ * telling the receiver which one is used:
+ *  - float32 : 4 bytes, full precision.
+ *  - int24   : 3 bytes, integer counts of 2^-frac_bits unit.
+ *  - float16 : 2 bytes, IEEE-754 half precision, 11 significant bits.
+ * A scaled int16 encoding would have the same size as float16 and can't be detected.
+ * frac_bits isn't sent, each type defines it as a protocol constant all nodes must share.
+ */
+typedef enum
+{
+    OD_FLOAT16 = 2, /*!< IEEE-754 half precision float. */
+    OD_INT24   = 3, /*!< Signed 24 bits counts of 2^-frac_bits unit. */
+    OD_FLOAT32 = 4  /*!< IEEE-754 single precision float. */
+} od_encoding_t;
+
+#ifndef OD_ENCODING
+#define OD_ENCODING OD_FLOAT32
+#endif
+
+#define OD_INT24_MAX 0x007FFFFF
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+#ifdef OD_FIXED_POINT
+/******************************************************************************
+ * @brief saturate a scaled Q16.16 value to the od_value_t range
+ * @param value to saturate
+ * @return value
+ ******************************************************************************/
+static inline od_value_t OD_FixedSaturate(int64_t value)
+{
+    if (value > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (value < INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+    return (od_value_t)value;
+}
+
+/******************************************************************************
+ * @brief convert a Q16.16 value into IEEE-754 float32 bits using integers only
+ * @param value to convert
+ * @return float32 bits, rounded to the nearest even
+ ******************************************************************************/
+static inline uint32_t OD_FixedToFloat32(od_value_t value)
+{
+    uint32_t sign = 0;
+    uint32_t mag  = (uint32_t)value;
+    if (value == 0)
+    {
+        return 0;
+    }
+    if (value < 0)
+    {
+        sign = 0x80000000;
+        mag  = 0 - mag;
+    }
+    // Find the most significant bit
+    int8_t msb = 31;
+    while ((mag & (1UL << msb)) == 0)
+    {
+        msb--;
+    }
+    uint32_t exponent = (uint32_t)(msb - OD_FIXED_FRAC_BITS + 127);
+    uint32_t mantissa;
+    if (msb > 23)
+    {
+        uint8_t shift = (uint8_t)(msb - 23);
+        mantissa      = (mag + (1UL << (shift - 1)) - 1 + ((mag >> shift) & 1)) >> shift;
+        if (mantissa & 0x01000000)
+        {
+            // Rounding overflowed into the next power of 2
+            mantissa >>= 1;
+            exponent++;
+        }
+    }
+    else
+    {
+        mantissa = mag << (23 - msb);
+    }
+    return sign | (exponent << 23) | (mantissa & 0x007FFFFF);
+}
+
+/******************************************************************************
+ * @brief convert IEEE-754 float32 bits into a Q16.16 value using integers only
+ * @param bits float32 to convert
+ * @return value rounded to the nearest, saturated if out of range
+ ******************************************************************************/
+static inline od_value_t OD_Float32ToFixed(uint32_t bits)
+{
+    int16_t exponent  = (int16_t)((bits >> 23) & 0xFF);
+    uint32_t mantissa = (bits & 0x007FFFFF) | 0x00800000;
+    uint32_t mag;
+    if (exponent == 0)
+    {
+        // Zero and denormals are far below the resolution
+        return 0;
+    }
+    // Shift the 1.23 mantissa to reach a 16 bits fraction
+    int16_t shift = exponent - 127 - 23 + OD_FIXED_FRAC_BITS;
+    if (shift >= 8)
+    {
+        // Out of range, infinite or NaN
+        return (bits & 0x80000000) ? INT32_MIN : INT32_MAX;
+    }
+    else if (shift >= 0)
+    {
+        mag = mantissa << shift;
+    }
+    else if (shift > -25)
+    {
+        mag = (mantissa + (1UL << (-shift - 1))) >> -shift;
+    }
+    else
+    {
+        return 0;
+    }
+    return (bits & 0x80000000) ? -(od_value_t)mag : (od_value_t)mag;
+}
+#endif
+
+/******************************************************************************
+ * @brief read an OD value from its float32 wire form
+ * @param data pointer to the 4 bytes of the float32
+ * @return value
+ ******************************************************************************/
+static inline od_value_t OD_ValueFromFloat32(const void *data)
+{
+#ifdef OD_FIXED_POINT
+    uint32_t bits;
+    memcpy(&bits, data, sizeof(uint32_t));
+    return OD_Float32ToFixed(bits);
+#else
+    od_value_t value;
+    memcpy(&value, data, sizeof(od_value_t));
+    return value;
+#endif
+}
+
+/******************************************************************************
+ * @brief write an OD value into its float32 wire form
+ * @param data pointer to the 4 bytes of the float32
+ * @param value to write
+ * @return None
+ ******************************************************************************/
+static inline void OD_ValueToFloat32(void *data, od_value_t value)
+{
+#ifdef OD_FIXED_POINT
+    uint32_t bits = OD_FixedToFloat32(value);
+    memcpy(data, &bits, sizeof(uint32_t));
+#else
+    memcpy(data, &value, sizeof(od_value_t));
+#endif
+}
+
+/******************************************************************************
+ * @brief check if a value moved further than a deadband from a reference
+ * @param reference value
+ * @param value to check
+ * @param deadband maximum distance between the values
+ * @return true if the distance is bigger than the deadband
+ ******************************************************************************/
+static inline uint8_t OD_ValueMoved(od_value_t reference, od_value_t value, od_value_t deadband)
+{
+#ifdef OD_FIXED_POINT
+    // The distance of two Q16.16 values can overflow 32 bits
+    int64_t distance = (int64_t)value - (int64_t)reference;
+#else
+    od_value_t distance = value - reference;
+#endif
+    return (distance > deadband) || (-distance > deadband);
+}
+
+/******************************************************************************
+ * @brief convert IEEE-754 float32 bits into float16 bits
+ * @param bits float32 to convert
+ * @return float16 bits, rounded to the nearest even
+ ******************************************************************************/
+static inline uint16_t OD_Float32ToFloat16(uint32_t bits)
+{
+    uint16_t sign     = (uint16_t)((bits >> 16) & 0x8000);
+    int16_t exponent  = (int16_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x007FFFFF;
+    uint8_t shift     = 13;
+    if (((bits >> 23) & 0xFF) == 0xFF)
+    {
+        // Infinite or NaN
+        return sign | 0x7C00 | (mantissa ? 0x0200 : 0);
+    }
+    if (exponent >= 31)
+    {
+        // Too big, saturate to infinite
+        return sign | 0x7C00;
+    }
+    if (exponent <= 0)
+    {
+        // Subnormal float16
+        if (exponent < -10)
+        {
+            return sign;
+        }
+        mantissa |= 0x00800000;
+        shift    = (uint8_t)(14 - exponent);
+        exponent = 0;
+    }
+    uint32_t half      = ((uint32_t)exponent << 10) | (mantissa >> shift);
+    uint32_t remainder = mantissa & ((1UL << shift) - 1);
+    uint32_t halfway   = 1UL << (shift - 1);
+    if ((remainder > halfway) || ((remainder == halfway) && (half & 1)))
+    {
+        // A carry goes to the exponent and may reach infinite
+        half++;
+    }
+    return sign | (uint16_t)half;
+}
+
+/******************************************************************************
+ * @brief convert float16 bits into IEEE-754 float32 bits
+ * @param half float16 to convert
+ * @return float32 bits
+ ******************************************************************************/
+static inline uint32_t OD_Float16ToFloat32(uint16_t half)
+{
+    uint32_t sign     = (uint32_t)(half & 0x8000) << 16;
+    int16_t exponent  = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x03FF;
+    if (exponent == 0x1F)
+    {
+        // Infinite or NaN
+        return sign | 0x7F800000 | (mantissa << 13);
+    }
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+        {
+            return sign;
+        }
+        // Normalize the subnormal float16
+        exponent = 1;
+        while ((mantissa & 0x0400) == 0)
+        {
+            mantissa <<= 1;
+            exponent--;
+        }
+        mantissa &= 0x03FF;
+    }
+    return sign | ((uint32_t)(exponent - 15 + 127) << 23) | (mantissa << 13);
+}
+
+/******************************************************************************
+ * @brief convert an OD value into 24 bits counts
+ * @param value to convert
+ * @param frac_bits number of counts per unit in power of 2
+ * @return counts rounded to the nearest, saturated on 24 bits
+ ******************************************************************************/
+static inline int32_t OD_ValueToInt24(od_value_t value, uint8_t frac_bits)
+{
+#ifdef OD_FIXED_POINT
+    int64_t counts;
+    if (frac_bits < OD_FIXED_FRAC_BITS)
+    {
+        uint8_t shift = OD_FIXED_FRAC_BITS - frac_bits;
+        counts        = ((value >> (shift - 1)) + 1) >> 1;
+    }
+    else
+    {
+        counts = (int64_t)value << (frac_bits - OD_FIXED_FRAC_BITS);
+    }
+#else
+    float counts = value * (float)(1UL << frac_bits);
+    counts += (counts >= 0.0f) ? 0.5f : -0.5f;
+#endif
+    if (counts > OD_INT24_MAX)
+    {
+        return OD_INT24_MAX;
+    }
+    if (counts < -OD_INT24_MAX)
+    {
+        return -OD_INT24_MAX;
+    }
+    return (int32_t)counts;
+}
+
+/******************************************************************************
+ * @brief convert 24 bits counts into an OD value
+ * @param counts to convert
+ * @param frac_bits number of counts per unit in power of 2
+ * @return value
+ ******************************************************************************/
+static inline od_value_t OD_ValueFromInt24(int32_t counts, uint8_t frac_bits)
+{
+#ifdef OD_FIXED_POINT
+    if (frac_bits > OD_FIXED_FRAC_BITS)
+    {
+        uint8_t shift = frac_bits - OD_FIXED_FRAC_BITS;
+        return ((counts >> (shift - 1)) + 1) >> 1;
+    }
+    int64_t value = (int64_t)counts << (OD_FIXED_FRAC_BITS - frac_bits);
+    if (value > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (value < -INT32_MAX)
+    {
+        return -INT32_MAX;
+    }
+    return (od_value_t)value;
+#else
+    return (float)counts / (float)(1UL << frac_bits);
+#endif
+}
+
+/******************************************************************************
+ * @brief write an OD value into a message using the given encoding
+ * @param msg to fill, only data and size are set
+ * @param value to send
+ * @param encoding of the value on the wire
+ * @param frac_bits resolution used by the int24 encoding
+ * @return None
+ ******************************************************************************/
+static inline void OD_ValueToMsg(msg_t *const msg, od_value_t value, od_encoding_t encoding, uint8_t frac_bits)
+{
+    switch (encoding)
+    {
+        case OD_FLOAT16:
+        {
+            uint32_t bits;
+            OD_ValueToFloat32(&bits, value);
+            uint16_t half = OD_Float32ToFloat16(bits);
+            msg->data[0]  = (uint8_t)half;
+            msg->data[1]  = (uint8_t)(half >> 8);
+            break;
+        }
+        case OD_INT24:
+        {
+            uint32_t counts = (uint32_t)OD_ValueToInt24(value, frac_bits);
+            msg->data[0]    = (uint8_t)counts;
+            msg->data[1]    = (uint8_t)(counts >> 8);
+            msg->data[2]    = (uint8_t)(counts >> 16);
+            break;
+        }
+        default:
+            encoding = OD_FLOAT32;
+            OD_ValueToFloat32(msg->data, value);
+            break;
+    }
+    msg->header.size = (uint16_t)encoding;
+}
+
+/******************************************************************************
+ * @brief read an OD value from a payload, the encoding is found using its size
+ * @param value to update, untouched if the size doesn't match any encoding
+ * @param data pointer to the payload
+ * @param size of the payload
+ * @param frac_bits resolution used by the int24 encoding
+ * @return None
+ ******************************************************************************/
+static inline void OD_ValueFromData(od_value_t *const value, const uint8_t *data, uint16_t size, uint8_t frac_bits)
+{
+    switch (size)
+    {
+        case OD_FLOAT16:
+        {
+            uint16_t half = (uint16_t)(data[0] | (data[1] << 8));
+            uint32_t bits = OD_Float16ToFloat32(half);
+            *value        = OD_ValueFromFloat32(&bits);
+            break;
+        }
+        case OD_INT24:
+        {
+            uint32_t counts = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16);
+            if (counts & 0x00800000)
+            {
+                // Sign extension
+                counts |= 0xFF000000;
+            }
+            *value = OD_ValueFromInt24((int32_t)counts, frac_bits);
+            break;
+        }
+        case OD_FLOAT32:
+            *value = OD_ValueFromFloat32(data);
+            break;
+        default:
+            break;
+    }
+}
+
+/******************************************************************************
+ * @brief read an OD value from a message, the encoding is found using its size
+ * @param value to update, untouched if the message size doesn't match any encoding
+ * @param msg received
+ * @param frac_bits resolution used by the int24 encoding
+ * @return None
+ ******************************************************************************/
+static inline void OD_ValueFromMsg(od_value_t *const value, const msg_t *const msg, uint8_t frac_bits)
+{
+    OD_ValueFromData(value, msg->data, msg->header.size, frac_bits);
+}
+
+#endif /* OD_OD_VALUE_H_ */
@@ -27,6 +27,7 @@ typedef struct
     //Virtual container management
     ll_container_t ll_container_table[MAX_CONTAINER_NUMBER]; /*!< Virtual Container table. */
     uint16_t ll_container_number;                            /*!< Virtual Container number. */
+    uint8_t cmd_filter[CMD_FILTER_SIZE];                     /*!< Bitmap of the commands accepted by at least one container. */
 
 } context_t;
 
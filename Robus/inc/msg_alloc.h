@@ -42,6 +42,7 @@ void MsgAlloc_LuosTaskAlloc(ll_container_t *container_concerned_by_current_msg,
 
 // Luos task research and pull
 error_return_t MsgAlloc_PullMsg(ll_container_t *target_container, msg_t **returned_msg);
+uint16_t MsgAlloc_GatherMsg(ll_container_t *target_container, msg_t **returned_msg, uint16_t max_nb);
 error_return_t MsgAlloc_PullMsgFromLuosTask(uint16_t luos_task_id, msg_t **returned_msg);
 error_return_t MsgAlloc_LookAtLuosTask(uint16_t luos_task_id, ll_container_t **allocated_container);
 error_return_t MsgAlloc_GetLuosTaskSourceId(uint16_t luos_task_id, uint16_t *source_id);
@@ -51,10 +52,11 @@ uint16_t MsgAlloc_LuosTasksNbr(void);
 void MsgAlloc_ClearMsgFromLuosTasks(msg_t *msg);
 
 // Tx tasks create, get and consume
-error_return_t MsgAlloc_SetTxTask(ll_container_t *ll_container_pt, uint8_t *data, uint16_t crc, uint16_t size, uint8_t locahost, uint8_t ack);
+error_return_t MsgAlloc_SetTxTask(ll_container_t *ll_container_pt, const uint8_t *header, const data_span_t *spans, uint8_t span_nb, uint16_t crc, uint16_t size, uint8_t locahost, uint8_t ack);
 void MsgAlloc_PullMsgFromTxTask(void);
 void MsgAlloc_PullContainerFromTxTask(uint16_t container_id);
 error_return_t MsgAlloc_GetTxTask(ll_container_t **ll_container_pt, uint8_t **data, uint16_t *size, uint8_t *locahost);
 error_return_t MsgAlloc_TxAllComplete(void);
+error_return_t MsgAlloc_TaskPending(void);
 
 #endif /* _MSGALLOC_H_ */
@@ -54,6 +54,7 @@ void Recep_EndMsg(void);
 void Recep_Reset(void);
 void Recep_Timeout(void);
 void Recep_InterpretMsgProtocol(msg_t *msg);
+uint8_t Recep_CmdAccepted(volatile uint8_t *cmd_filter, uint8_t cmd);
 uint8_t Recep_NodeConcerned(header_t *header);
 ll_container_t *Recep_GetConcernedLLContainer(header_t *header);
 
@@ -24,7 +24,10 @@ void Robus_Init(memory_stats_t *memory_stats);
 void Robus_Loop(void);
 ll_container_t *Robus_ContainerCreate(uint16_t type);
 void Robus_ContainersClear(void);
+void Robus_FilterCmd(ll_container_t *ll_container, uint8_t first_cmd, uint8_t last_cmd, uint8_t accept);
+void Robus_SetCmdFilter(ll_container_t *ll_container, const uint8_t *cmd_filter);
 error_return_t Robus_SendMsg(ll_container_t *ll_container, msg_t *msg);
+error_return_t Robus_SendMsgSpans(ll_container_t *ll_container, msg_t *msg, const data_span_t *spans, uint8_t span_nb);
 uint16_t Robus_TopologyDetection(ll_container_t *ll_container);
 node_t *Robus_GetNode(void);
 void Robus_Flush(void);
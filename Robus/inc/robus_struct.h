@@ -13,6 +13,7 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+#define CMD_FILTER_SIZE (256 / 8) /*!< Number of bytes needed to store a bit per command. */
 
 /******************************************************************************
  * @struct memory_stats_t
@@ -82,6 +83,17 @@ typedef struct __attribute__((__packed__))
     };
 } msg_t;
 
+/* This structure is used to send a message payload split into multiple memory areas
+ * without gathering it into a msg_t first.
+ */
+typedef struct
+{
+    const uint8_t *data; /*!< Begin of the contiguous memory area. */
+    uint16_t size;       /*!< Size of the memory area in bytes. */
+} data_span_t;
+
+#define MAX_DATA_SPAN 3 /*!< Maximum number of data spans of a message payload. */
+
 /* This structure is used to manage virtual containers
  * please refer to the documentation
  */
@@ -96,6 +108,7 @@ typedef struct __attribute__((__packed__))
     uint16_t max_multicast_target;                         /*!< Position pointer of the last multicast target. */
     uint16_t multicast_target_bank[MAX_MULTICAST_ADDRESS]; /*!< multicast target bank. */
     uint16_t dead_container_spotted;                       /*!< The ID of a container that don't reply to a lot of ACK msg */
+    uint8_t cmd_filter[CMD_FILTER_SIZE];                   /*!< Bitmap of the commands accepted by this container. */
 
     //variable stat on robus com for ll_container
     ll_stats_t ll_stat;
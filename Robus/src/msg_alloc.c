@@ -433,6 +433,8 @@ void MsgAlloc_EndMsg(void)
         MsgAlloc_OldestMsgCandidate((msg_t *)msg_tasks[0]);
     }
     msg_tasks_stack_id++;
+    // A message is available, wake up the node
+    node_wakeup();
     //******** Prepare the next msg *********
     //data_ptr is actually 2 bytes after the message data because of the CRC. Remove the CRC.
     data_ptr -= 2;
@@ -716,6 +718,31 @@ error_return_t MsgAlloc_PullMsg(ll_container_t *target_module, msg_t **returned_
     // At this point we don't find any message for this module
     return FAILED;
 }
+/******************************************************************************
+ * @brief Get all the messages allocated to a specific container without pulling them
+ * @param target_module : The module concerned by the messages
+ * @param returned_msg : Table of message pointers to fill in arrival order.
+ * @param max_nb : Size of the table.
+ * @return number of messages
+ ******************************************************************************/
+uint16_t MsgAlloc_GatherMsg(ll_container_t *target_module, msg_t **returned_msg, uint16_t max_nb)
+{
+    uint16_t nb = 0;
+    MsgAlloc_ValidDataIntegrity();
+    for (uint16_t i = 0; (i < luos_tasks_stack_id) && (nb < max_nb); i++)
+    {
+        if (luos_tasks[i].ll_container_pt == target_module)
+        {
+            returned_msg[nb++] = luos_tasks[i].msg_pt;
+        }
+    }
+    if (nb > 0)
+    {
+        // The oldest message is the first one to be overwritten
+        used_msg = returned_msg[0];
+    }
+    return nb;
+}
 /******************************************************************************
  * @brief Pull a message allocated to a specific luos task
  * @param luos_task_id : Id of the allocator luos task
@@ -833,12 +860,14 @@ void MsgAlloc_ClearMsgFromLuosTasks(msg_t *msg)
 
 /******************************************************************************
  * @brief copy a message to transmit into msg_buffer and create a Tx task
- * @param data to transmit
+ * @param header of the message to transmit
+ * @param spans list of memory areas containing the payload to transmit
+ * @param span_nb number of spans
  * @param size of the data to transmit
  ******************************************************************************/
-error_return_t MsgAlloc_SetTxTask(ll_container_t *ll_container_pt, uint8_t *data, uint16_t crc, uint16_t size, uint8_t locahost, uint8_t ack)
+error_return_t MsgAlloc_SetTxTask(ll_container_t *ll_container_pt, const uint8_t *header, const data_span_t *spans, uint8_t span_nb, uint16_t crc, uint16_t size, uint8_t locahost, uint8_t ack)
 {
-    LUOS_ASSERT((tx_tasks_stack_id >= 0) && (tx_tasks_stack_id < MAX_MSG_NB) && ((uint32_t)data > 0) && ((uint32_t)current_msg < (uint32_t)&msg_buffer[MSG_BUFFER_SIZE]) && ((uint32_t)current_msg >= (uint32_t)&msg_buffer[0]));
+    LUOS_ASSERT((tx_tasks_stack_id >= 0) && (tx_tasks_stack_id < MAX_MSG_NB) && ((uint32_t)header > 0) && ((uint32_t)current_msg < (uint32_t)&msg_buffer[MSG_BUFFER_SIZE]) && ((uint32_t)current_msg >= (uint32_t)&msg_buffer[0]));
     void *rx_msg_bkp          = 0;
     void *tx_msg              = 0;
     uint16_t progression_size = 0;
@@ -935,7 +964,7 @@ error_return_t MsgAlloc_SetTxTask(ll_container_t *ll_container_pt, uint8_t *data
 
     // Copy 3 bytes from the message to transmit just to be sure to be ready to start transmitting
     // During those 3 bytes we have the time necessary to copy the other bytes
-    memcpy((void *)tx_msg, (void *)data, 3);
+    memcpy((void *)tx_msg, (void *)header, 3);
     // Now we are ready to transmit, we can create the tx task
 
     LuosHAL_SetIrqState(false);
@@ -953,20 +982,21 @@ error_return_t MsgAlloc_SetTxTask(ll_container_t *ll_container_pt, uint8_t *data
     LuosHAL_SetIrqState(true);
 
     //finish the copy
-    if (ack != 0)
+    // 3 bytes of the header already copied
+    uint8_t *tx_data = (uint8_t *)tx_msg + 3;
+    memcpy((void *)tx_data, (void *)&header[3], sizeof(header_t) - 3);
+    tx_data += sizeof(header_t) - 3;
+    // Gather the payload spans
+    for (uint8_t i = 0; i < span_nb; i++)
     {
-        // Finish the copy of the message to transmit
-        memcpy((void *)&((char *)tx_msg)[3], (void *)&data[3], size - 6); // 3 bytes already copied - 2 bytes CRC - 1 byte ack
-        ((char *)tx_msg)[size - 3] = (uint8_t)(crc);
-        ((char *)tx_msg)[size - 2] = (uint8_t)(crc >> 8);
-        ((char *)tx_msg)[size - 1] = ack;
+        memcpy((void *)tx_data, (void *)spans[i].data, spans[i].size);
+        tx_data += spans[i].size;
     }
-    else
+    tx_data[0] = (uint8_t)(crc);
+    tx_data[1] = (uint8_t)(crc >> 8);
+    if (ack != 0)
     {
-        // Finish the copy of the message to transmit
-        memcpy((void *)&((char *)tx_msg)[3], (void *)&data[3], size - 5); // 3 bytes already copied - 2 bytes CRC
-        ((char *)tx_msg)[size - 2] = (uint8_t)(crc);
-        ((char *)tx_msg)[size - 1] = (uint8_t)(crc >> 8);
+        tx_data[2] = ack;
     }
     //manage localhost
     if (locahost)
@@ -1078,3 +1108,16 @@ error_return_t MsgAlloc_TxAllComplete(void)
     }
     return SUCCEED;
 }
+/******************************************************************************
+ * @brief check if there is messages to interpret or memory tasks waiting for a loop
+ * Messages already allocated to containers are not counted (see MsgAlloc_LuosTasksNbr).
+ * @return error_return_t : SUCCEED if something have to be done out of IRQ.
+ ******************************************************************************/
+error_return_t MsgAlloc_TaskPending(void)
+{
+    if ((msg_tasks_stack_id > 0) || (copy_task_pointer != NULL) || (mem_clear_needed == true))
+    {
+        return SUCCEED;
+    }
+    return FAILED;
+}
@@ -99,6 +99,14 @@ void Recep_GetHeader(volatile uint8_t *data)
                 data_size = current_msg->header.size;
             }
 
+            // Drop commands that no container accept before allocating any space for it.
+            // Messages needing an ACK are received anyway to be acknowledged.
+            if ((current_msg->header.target_mode != IDACK) && (current_msg->header.target_mode != NODEIDACK) && (Recep_CmdAccepted(ctx.cmd_filter, current_msg->header.cmd) == false))
+            {
+                MsgAlloc_ValidHeader(false, data_size);
+                ctx.rx.callback = Recep_Drop;
+                return;
+            }
             if ((ctx.rx.status.rx_framing_error == false))
             {
                 if (data_size)
@@ -403,7 +411,10 @@ void Recep_InterpretMsgProtocol(msg_t *msg)
             {
                 if (msg->header.target == ctx.ll_container_table[i].id)
                 {
-                    MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
+                    if (Recep_CmdAccepted(ctx.ll_container_table[i].cmd_filter, msg->header.cmd))
+                    {
+                        MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
+                    }
                     return;
                 }
             }
@@ -412,7 +423,7 @@ void Recep_InterpretMsgProtocol(msg_t *msg)
             // Check all ll_container type
             for (i = 0; i < ctx.ll_container_number; i++)
             {
-                if (msg->header.target == ctx.ll_container_table[i].type)
+                if ((msg->header.target == ctx.ll_container_table[i].type) && (Recep_CmdAccepted(ctx.ll_container_table[i].cmd_filter, msg->header.cmd)))
                 {
                     MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
                     return;
@@ -422,14 +433,17 @@ void Recep_InterpretMsgProtocol(msg_t *msg)
         case BROADCAST:
             for (i = 0; i < ctx.ll_container_number; i++)
             {
-                MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
+                if (Recep_CmdAccepted(ctx.ll_container_table[i].cmd_filter, msg->header.cmd))
+                {
+                    MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
+                }
             }
             return;
             break;
         case MULTICAST:
             for (i = 0; i < ctx.ll_container_number; i++)
             {
-                if (Trgt_MulticastTargetBank((ll_container_t *)&ctx.ll_container_table[i], msg->header.target))
+                if ((Trgt_MulticastTargetBank((ll_container_t *)&ctx.ll_container_table[i], msg->header.target)) && (Recep_CmdAccepted(ctx.ll_container_table[i].cmd_filter, msg->header.cmd)))
                 {
                     //TODO manage multiple slave concerned
                     MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
@@ -446,7 +460,10 @@ void Recep_InterpretMsgProtocol(msg_t *msg)
             }
             for (i = 0; i < ctx.ll_container_number; i++)
             {
-                MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
+                if (Recep_CmdAccepted(ctx.ll_container_table[i].cmd_filter, msg->header.cmd))
+                {
+                    MsgAlloc_LuosTaskAlloc((ll_container_t *)&ctx.ll_container_table[i], msg);
+                }
             }
             return;
             break;
@@ -454,3 +471,18 @@ void Recep_InterpretMsgProtocol(msg_t *msg)
             break;
     }
 }
+/******************************************************************************
+ * @brief Check if a command is accepted by a command filter
+ * Robus protocol commands are always accepted.
+ * @param cmd_filter bitmap of accepted commands
+ * @param cmd to check
+ * @return true if the command is accepted
+ ******************************************************************************/
+uint8_t Recep_CmdAccepted(volatile uint8_t *cmd_filter, uint8_t cmd)
+{
+    if (cmd < ROBUS_PROTOCOL_NB)
+    {
+        return true;
+    }
+    return ((cmd_filter[cmd >> 3] & (1u << (cmd & 0x07))) != 0);
+}
@@ -36,6 +36,8 @@ typedef struct __attribute__((__packed__))
 static error_return_t Robus_MsgHandler(msg_t *input);
 static error_return_t Robus_DetectNextNodes(ll_container_t *ll_container);
 static error_return_t Robus_ResetNetworkDetection(ll_container_t *ll_container);
+static uint16_t Robus_ComputeCRC(uint16_t crc_val, const uint8_t *data, uint16_t size);
+static void Robus_UpdateNodeFilter(void);
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -122,6 +124,9 @@ ll_container_t *Robus_ContainerCreate(uint16_t type)
     ctx.ll_container_table[ctx.ll_container_number].dead_container_spotted = 0;
     // Clear stats
     ctx.ll_container_table[ctx.ll_container_number].ll_stat.max_retry = 0;
+    // By default a container accept all commands
+    memset((void *)ctx.ll_container_table[ctx.ll_container_number].cmd_filter, 0xFF, sizeof(ctx.cmd_filter));
+    memset((void *)ctx.cmd_filter, 0xFF, sizeof(ctx.cmd_filter));
     // Return the freshly initialized ll_container pointer.
     return (ll_container_t *)&ctx.ll_container_table[ctx.ll_container_number++];
 }
@@ -136,6 +141,85 @@ void Robus_ContainersClear(void)
     memset((void *)ctx.ll_container_table, 0, sizeof(ll_container_t) * MAX_CONTAINER_NUMBER);
     // Reset the number of created containers
     ctx.ll_container_number = 0;
+    // No more container to accept commands
+    memset((void *)ctx.cmd_filter, 0, sizeof(ctx.cmd_filter));
+}
+/******************************************************************************
+ * @brief Select commands accepted by a container
+ * Messages with a command accepted by no container are dropped at reception.
+ * @param ll_container to configure
+ * @param first_cmd first command of the range
+ * @param last_cmd last command of the range
+ * @param accept true to accept the range, false to drop it
+ * @return None
+ ******************************************************************************/
+void Robus_FilterCmd(ll_container_t *ll_container, uint8_t first_cmd, uint8_t last_cmd, uint8_t accept)
+{
+    LUOS_ASSERT(first_cmd <= last_cmd);
+    for (uint16_t cmd = first_cmd; cmd <= last_cmd; cmd++)
+    {
+        if (accept)
+        {
+            ll_container->cmd_filter[cmd >> 3] |= (uint8_t)(1u << (cmd & 0x07));
+        }
+        else
+        {
+            ll_container->cmd_filter[cmd >> 3] &= (uint8_t)~(1u << (cmd & 0x07));
+        }
+    }
+    Robus_UpdateNodeFilter();
+}
+/******************************************************************************
+ * @brief Replace all the commands accepted by a container
+ * @param ll_container to configure
+ * @param cmd_filter bitmap of the accepted commands
+ * @return None
+ ******************************************************************************/
+void Robus_SetCmdFilter(ll_container_t *ll_container, const uint8_t *cmd_filter)
+{
+    memcpy(ll_container->cmd_filter, cmd_filter, CMD_FILTER_SIZE);
+    Robus_UpdateNodeFilter();
+}
+/******************************************************************************
+ * @brief Update the node filter with the commands of all containers
+ * @param None
+ * @return None
+ ******************************************************************************/
+static void Robus_UpdateNodeFilter(void)
+{
+    LuosHAL_SetIrqState(false);
+    for (uint8_t byte = 0; byte < CMD_FILTER_SIZE; byte++)
+    {
+        ctx.cmd_filter[byte] = 0;
+        for (uint16_t i = 0; i < ctx.ll_container_number; i++)
+        {
+            ctx.cmd_filter[byte] |= ctx.ll_container_table[i].cmd_filter[byte];
+        }
+    }
+    LuosHAL_SetIrqState(true);
+}
+/******************************************************************************
+ * @brief compute the CRC of a memory area
+ * @param crc_val previous CRC value
+ * @param data to compute
+ * @param size of the data
+ * @return new CRC value
+ ******************************************************************************/
+static uint16_t Robus_ComputeCRC(uint16_t crc_val, const uint8_t *data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++)
+    {
+        uint16_t dbyte = data[i];
+        crc_val ^= dbyte << 8;
+        for (uint8_t j = 0; j < 8; ++j)
+        {
+            uint16_t mix = crc_val & 0x8000;
+            crc_val      = (crc_val << 1);
+            if (mix)
+                crc_val = crc_val ^ 0x0007;
+        }
+    }
+    return crc_val;
 }
 /******************************************************************************
  * @brief Send Msg to a container
@@ -144,10 +228,39 @@ void Robus_ContainersClear(void)
  * @return none
  ******************************************************************************/
 error_return_t Robus_SendMsg(ll_container_t *ll_container, msg_t *msg)
+{
+    data_span_t span;
+    // Compute the data size based on the header size info.
+    span.data = msg->data;
+    if (msg->header.size > MAX_DATA_MSG_SIZE)
+    {
+        span.size = MAX_DATA_MSG_SIZE;
+    }
+    else
+    {
+        span.size = msg->header.size;
+    }
+    return Robus_SendMsgSpans(ll_container, msg, &span, 1);
+}
+/******************************************************************************
+ * @brief Send Msg to a container taking the payload from memory areas
+ * The payload is directly copied from the spans into the transmit buffer.
+ * msg->header.size have to be set by the caller, if the spans are smaller than
+ * the message the end of msg->data is used as padding.
+ * @param container to send
+ * @param msg containing the header to send
+ * @param spans list of memory areas containing the payload
+ * @param span_nb number of spans (MAX_DATA_SPAN max)
+ * @return error
+ ******************************************************************************/
+error_return_t Robus_SendMsgSpans(ll_container_t *ll_container, msg_t *msg, const data_span_t *spans, uint8_t span_nb)
 {
     uint8_t ack        = 0;
     uint16_t data_size = 0;
+    uint16_t span_size = 0;
     uint16_t crc_val   = 0xFFFF;
+    data_span_t tx_spans[MAX_DATA_SPAN + 1];
+    LUOS_ASSERT(span_nb <= MAX_DATA_SPAN);
     // ********** Prepare the message ********************
     // Set protocol revision and source ID on the message
     msg->header.protocol = PROTOCOL_REVISION;
@@ -169,21 +282,27 @@ error_return_t Robus_SendMsg(ll_container_t *ll_container, msg_t *msg)
     {
         data_size = msg->header.size;
     }
+    for (uint8_t i = 0; i < span_nb; i++)
+    {
+        tx_spans[i] = spans[i];
+        span_size += spans[i].size;
+    }
+    LUOS_ASSERT(span_size <= data_size);
+    if (span_size < data_size)
+    {
+        // The receiver expect a full message when more data follows, pad it
+        tx_spans[span_nb].data = msg->data;
+        tx_spans[span_nb].size = data_size - span_size;
+        span_nb++;
+    }
     // Add the CRC to the total size of the message
     uint16_t full_size = sizeof(header_t) + data_size + 2;
 
     // compute the CRC
-    for (uint16_t i = 0; i < full_size - 2; i++)
+    crc_val = Robus_ComputeCRC(crc_val, msg->stream, sizeof(header_t));
+    for (uint8_t i = 0; i < span_nb; i++)
     {
-        uint16_t dbyte = msg->stream[i];
-        crc_val ^= dbyte << 8;
-        for (uint8_t j = 0; j < 8; ++j)
-        {
-            uint16_t mix = crc_val & 0x8000;
-            crc_val      = (crc_val << 1);
-            if (mix)
-                crc_val = crc_val ^ 0x0007;
-        }
+        crc_val = Robus_ComputeCRC(crc_val, tx_spans[i].data, tx_spans[i].size);
     }
 
     // Check the localhost situation
@@ -197,7 +316,7 @@ error_return_t Robus_SendMsg(ll_container_t *ll_container, msg_t *msg)
     }
 
     // ********** Allocate the message ********************
-    if (MsgAlloc_SetTxTask(ll_container, (uint8_t *)msg->stream, crc_val, full_size, localhost, ack) == FAILED)
+    if (MsgAlloc_SetTxTask(ll_container, msg->header.unmap, tx_spans, span_nb, crc_val, full_size, localhost, ack) == FAILED)
     {
         return FAILED;
     }
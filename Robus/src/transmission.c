@@ -49,6 +49,7 @@
 #include "context.h"
 #include "reception.h"
 #include "msg_alloc.h"
+#include "luos_utils.h"
 
 /*******************************************************************************
  * Definitions
@@ -185,4 +186,6 @@ void Transmit_End(void)
     }
     // Try to send something if we need to.
     Transmit_Process();
+    // The transmission state changed, wake up the node
+    node_wakeup();
 }
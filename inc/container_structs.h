@@ -14,6 +14,34 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+#ifndef MAX_TIMED_UPDATE
+#define MAX_TIMED_UPDATE (2 * MAX_CONTAINER_NUMBER)
+#endif
+
+#ifndef MAX_TIMED_UPDATE_TARGET
+#define MAX_TIMED_UPDATE_TARGET 4
+#endif
+
+#ifndef TIMED_UPDATE_VALUE_SIZE
+#define TIMED_UPDATE_VALUE_SIZE 16
+#endif
+
+#ifndef MAX_LUOS_TIMER
+#define MAX_LUOS_TIMER (2 * MAX_CONTAINER_NUMBER)
+#endif
+
+#ifndef MAX_SLEEP_MS
+#define MAX_SLEEP_MS 1000
+#endif
+
+#ifndef MAX_LUOS_TASK
+#define MAX_LUOS_TASK (2 * MAX_CONTAINER_NUMBER)
+#endif
+
+#ifndef MAX_LUOS_REQUEST
+#define MAX_LUOS_REQUEST 16
+#endif
+
 /* store informations about luos stats
  * please refer to the documentation
  */
@@ -61,15 +89,113 @@ typedef struct __attribute__((__packed__)) container_stats_t
 } container_stats_t;
 
 /* This structure is used to manage containers timed auto update
+ * Subscribers of the same container with the same period share the same publication.
  * please refer to the documentation
  */
 typedef struct __attribute__((__packed__)) timed_update_t
 {
-    uint32_t last_update;
-    uint16_t time_ms;
-    uint16_t target;
+    uint32_t next_update;                     /*!< Date of the next publication. */
+    uint16_t time_ms;                         /*!< Publication period. */
+    uint16_t target[MAX_TIMED_UPDATE_TARGET]; /*!< Subscribers IDs. */
+    uint8_t target_nb;                        /*!< Number of subscribers. */
+    uint8_t container_index;                  /*!< Index of the published container. */
+    // On change publication
+    uint8_t on_change;                      /*!< True if values are published only when they change. */
+    uint16_t max_time_ms;                   /*!< Maximum time between two publications, 0 for none. */
+    od_value_t deadband;                    /*!< Minimum change of the value to publish it. */
+    uint32_t last_publish;                  /*!< Date of the last publication. */
+    uint8_t value_cmd;                      /*!< Command of the last published value. */
+    uint8_t value_size;                     /*!< Size of the last published value, 0 if nothing published. */
+    uint8_t value[TIMED_UPDATE_VALUE_SIZE]; /*!< Last published value. */
 } timed_update_t;
 
+/* This structure is the optional UPDATE_PUB payload asking for an on change publication
+ * A value is published when it moves further than the deadband from the last published one,
+ * at most every min_period and at least every max_period.
+ * A UPDATE_PUB containing only a time_luos_t ask for a periodic publication.
+ * All the fields are float32 on the wire whatever the od_value_t representation.
+ * please refer to the documentation
+ */
+typedef struct __attribute__((__packed__))
+{
+    time_luos_t min_period; /*!< Minimum time between two publications, 0 to unsubscribe. */
+    time_luos_t max_period; /*!< Maximum time between two publications, 0 for none. */
+    od_value_t deadband;    /*!< Minimum change to publish in the unit of the value. */
+} update_pub_t;
+
+struct container_t;
+
+/* This structure is used to link a range of commands to a container handler
+ * please refer to the documentation (see LUOS_DISPATCH_TABLE)
+ */
+typedef struct luos_dispatch_t
+{
+    uint8_t first_cmd;                                          /*!< First command of the range. */
+    uint8_t last_cmd;                                           /*!< Last command of the range. */
+    void (*handler)(struct container_t *container, msg_t *msg); /*!< Function managing this range. */
+} luos_dispatch_t;
+
+/* This structure is used to store a container command dispatch table
+ * please refer to the documentation (see LUOS_DISPATCH_TABLE)
+ */
+typedef struct
+{
+    const luos_dispatch_t *entries; /*!< Entries sorted by command. */
+    uint16_t nb;                    /*!< Number of entries. */
+} luos_dispatch_table_t;
+
+/* This structure is used to manage a Luos timer
+ * Timers are owned by the user and called back from Luos_Loop (see Luos_TimerStart).
+ * please refer to the documentation
+ */
+typedef struct luos_timer_t
+{
+    uint32_t deadline;                                                           /*!< Date of the next call. */
+    uint32_t period_ms;                                                          /*!< Period of the timer, 0 for a one shot timer. */
+    uint16_t heap_index;                                                         /*!< Position in the timer heap. */
+    struct container_t *container;                                               /*!< Container owning the timer. */
+    void (*callback)(struct container_t *container, struct luos_timer_t *timer); /*!< Function called on timer expiration. */
+} luos_timer_t;
+
+/*
+ * Luos task awaited event
+ */
+typedef enum
+{
+    TASK_WAIT_CONDITION,   /*!< Task polled on each Luos_Loop. */
+    TASK_WAIT_MSG,         /*!< Task waiting for a message. */
+    TASK_WAIT_MSG_OR_TIME, /*!< Task waiting for a message or a timeout. */
+    TASK_WAIT_TIME         /*!< Task waiting for a date. */
+} task_wait_t;
+
+/* This structure is used to manage a Luos cooperative task
+ * Tasks are stackless, local variables are not kept between awaits (see LUOS_TASK_BEGIN).
+ * please refer to the documentation
+ */
+typedef struct luos_task_t
+{
+    uint16_t line;                                                                /*!< Resume point of the task. */
+    task_wait_t wait;                                                             /*!< Awaited event. */
+    uint16_t wait_source;                                                         /*!< Source of the awaited message, 0 for any. */
+    uint8_t wait_cmd;                                                             /*!< Command of the awaited message. */
+    uint32_t deadline;                                                            /*!< Date of the awaited timeout. */
+    msg_t *msg;                                                                   /*!< Awaited message, NULL on timeout. Valid until the next await. */
+    struct container_t *container;                                                /*!< Container running the task. */
+    uint8_t (*function)(struct container_t *container, struct luos_task_t *task); /*!< Task body. */
+} luos_task_t;
+
+/* This structure is used to manage a request waiting for its reply (see Luos_Request)
+ * please refer to the documentation
+ */
+typedef struct luos_request_t
+{
+    uint16_t target;                                                                                   /*!< ID of the container replying. */
+    uint8_t cmd;                                                                                       /*!< Command of the request. */
+    uint32_t deadline;                                                                                 /*!< Date of the request timeout. */
+    struct container_t *container;                                                                     /*!< Container making the request. */
+    void (*callback)(struct container_t *container, struct luos_request_t *request, msg_t *reply_msg); /*!< Function receiving the reply. */
+} luos_request_t;
+
 /* This structure is used to manage containers
  * please refer to the documentation
  */
@@ -78,16 +204,23 @@ typedef struct __attribute__((__packed__)) container_t
     ll_container_t *ll_container;
     // Callback
     void (*cont_cb)(struct container_t *container, msg_t *msg);
+    const luos_dispatch_table_t *dispatch;                                         /*!< Commands dispatch table, replace cont_cb if set. */
+    uint16_t (*batch_cb)(struct container_t *container, msg_t **msg, uint16_t nb); /*!< Batch callback, receive all pending messages at once if set. */
+    uint16_t batch_held_nb;                                                        /*!< Messages left pending by the last batch callback call. */
+    uint8_t cmd_filter[CMD_FILTER_SIZE];                                           /*!< Commands accepted by the container (see Luos_AcceptCmd). */
     // Variables
     uint8_t default_alias[MAX_ALIAS_SIZE]; /*!< container default alias. */
     uint8_t alias[MAX_ALIAS_SIZE];         /*!< container alias. */
-    timed_update_t auto_refresh;           /*!< container auto refresh context. */
     revision_t revision;                   /*!< container firmware version. */
     luos_stats_t *node_statistics;         /*!< Node level statistics. */
     container_stats_t statistics;          /*!< container level statistics. */
 } container_t;
 
 typedef void (*CONT_CB)(container_t *container, msg_t *msg);
+typedef void (*TIMER_CB)(container_t *container, luos_timer_t *timer);
+typedef uint16_t (*BATCH_CB)(container_t *container, msg_t **msg, uint16_t nb);
+typedef uint8_t (*TASK_CB)(container_t *container, luos_task_t *task);
+typedef void (*REQUEST_CB)(container_t *container, luos_request_t *request, msg_t *reply_msg);
 
 /*
  * Control modes
@@ -17,6 +17,75 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+/* Create a const command dispatch table to register using Luos_SetDispatchTable.
+ * LIST is an X-macro list of CMD(cmd, handler) and RANGE(first_cmd, last_cmd, handler) sorted by command :
+ *
+ * #define SERVO_CMD_LIST(CMD, RANGE)          \
+ *     CMD(ASK_PUB_CMD, Servo_Publish)         \
+ *     CMD(ANGULAR_POSITION, Servo_MoveTo)     \
+ *     RANGE(LUOS_PROTOCOL_NB, 0xFF, Servo_Custom)
+ * LUOS_DISPATCH_TABLE(servo_dispatch, SERVO_CMD_LIST);
+ */
+#define LUOS_DISPATCH_CMD(cmd, handler)                   {(cmd), (cmd), (handler)},
+#define LUOS_DISPATCH_RANGE(first_cmd, last_cmd, handler) {(first_cmd), (last_cmd), (handler)},
+#define LUOS_DISPATCH_TABLE(name, LIST)                                                             \
+    static const luos_dispatch_t name##_entries[] = {LIST(LUOS_DISPATCH_CMD, LUOS_DISPATCH_RANGE)}; \
+    static const luos_dispatch_table_t name       = {name##_entries, sizeof(name##_entries) / sizeof(luos_dispatch_t)}
+
+/* Cooperative tasks scheduled by Luos_Loop, started using Luos_TaskStart.
+ * A task body is surrounded by LUOS_TASK_BEGIN and LUOS_TASK_END and can await events without blocking :
+ *
+ * uint8_t Gate_AskPosition(container_t *container, luos_task_t *task)
+ * {
+ *     LUOS_TASK_BEGIN(task);
+ *     Luos_SendMsg(container, &ask_msg);
+ *     LUOS_TASK_AWAIT_MSG(task, motor_id, ANGULAR_POSITION, 100);
+ *     if (task->msg != NULL) ...
+ *     LUOS_TASK_AWAIT_TIME(task, 10);
+ *     LUOS_TASK_END(task);
+ * }
+ *
+ * Tasks are stackless, local variables are lost on awaits and awaits can't be done inside a switch.
+ */
+#define LUOS_TASK_WAITING 0
+#define LUOS_TASK_ENDED   1
+
+#define LUOS_TASK_BEGIN(task) \
+    switch ((task)->line)     \
+    {                         \
+        case 0:
+#define LUOS_TASK_END(task) \
+    }                       \
+    (task)->line = 0;       \
+    return LUOS_TASK_ENDED
+#define LUOS_TASK_AWAIT_UNTIL(task, condition) \
+    do                                         \
+    {                                          \
+        (task)->wait = TASK_WAIT_CONDITION;    \
+        (task)->line = __LINE__;               \
+        case __LINE__:                         \
+            if (!(condition))                  \
+            {                                  \
+                return LUOS_TASK_WAITING;      \
+            }                                  \
+    } while (0)
+#define LUOS_TASK_AWAIT_MSG(task, source, cmd, timeout_ms)       \
+    do                                                           \
+    {                                                            \
+        Luos_TaskWaitMsg((task), (source), (cmd), (timeout_ms)); \
+        (task)->line = __LINE__;                                 \
+        return LUOS_TASK_WAITING;                                \
+        case __LINE__:;                                          \
+    } while (0)
+#define LUOS_TASK_AWAIT_TIME(task, delay_ms)   \
+    do                                         \
+    {                                          \
+        Luos_TaskWaitTime((task), (delay_ms)); \
+        (task)->line = __LINE__;               \
+        return LUOS_TASK_WAITING;              \
+        case __LINE__:;                        \
+    } while (0)
+#define LUOS_TASK_AWAIT_SEND(task) LUOS_TASK_AWAIT_UNTIL(task, Luos_TxComplete() == SUCCEED)
 
 /******************************************************************************
  * @struct general_stats_t
@@ -45,6 +114,9 @@ void Luos_Init(void);
 void Luos_Loop(void);
 void Luos_ContainersClear(void);
 container_t *Luos_CreateContainer(CONT_CB cont_cb, uint8_t type, const char *alias, revision_t revision);
+void Luos_SetDispatchTable(container_t *container, const luos_dispatch_table_t *dispatch);
+void Luos_SetBatchCallback(container_t *container, BATCH_CB batch_cb);
+void Luos_AcceptCmd(container_t *container, uint8_t first_cmd, uint8_t last_cmd, uint8_t accept);
 error_return_t Luos_SendMsg(container_t *container, msg_t *msg);
 error_return_t Luos_ReadMsg(container_t *container, msg_t **returned_msg);
 error_return_t Luos_ReadFromContainer(container_t *container, int16_t id, msg_t **returned_msg);
@@ -52,10 +124,22 @@ void Luos_SendData(container_t *container, msg_t *msg, void *bin_data, uint16_t
 error_return_t Luos_ReceiveData(container_t *container, msg_t *msg, void *bin_data);
 void Luos_SendStreaming(container_t *container, msg_t *msg, streaming_channel_t *stream);
 error_return_t Luos_ReceiveStreaming(container_t *container, msg_t *msg, streaming_channel_t *stream);
+error_return_t Luos_SendStreamingCredit(container_t *container, uint16_t target, streaming_channel_t *stream);
+error_return_t Luos_ReceiveStreamingCredit(msg_t *msg, streaming_channel_t *stream);
 void Luos_SendBaudrate(container_t *container, uint32_t baudrate);
 void Luos_SetExternId(container_t *container, target_mode_t target_mode, uint16_t target, uint16_t newid);
 uint16_t Luos_NbrAvailableMsg(void);
 uint32_t Luos_GetSystick(void);
+uint32_t Luos_GetIdleTime(void);
+uint32_t Luos_NextEventTick(void);
+void Luos_TimerStart(container_t *container, luos_timer_t *timer, uint32_t delay_ms, uint32_t period_ms, TIMER_CB callback);
+void Luos_TimerStop(luos_timer_t *timer);
+error_return_t Luos_TimerIsRunning(luos_timer_t *timer);
+void Luos_TaskStart(container_t *container, luos_task_t *task, TASK_CB function);
+void Luos_TaskStop(luos_task_t *task);
+void Luos_TaskWaitMsg(luos_task_t *task, uint16_t source, uint8_t cmd, uint32_t timeout_ms);
+void Luos_TaskWaitTime(luos_task_t *task, uint32_t delay_ms);
+error_return_t Luos_Request(container_t *container, uint16_t target, uint8_t cmd, void *payload, uint16_t size, uint32_t timeout_ms, REQUEST_CB callback);
 error_return_t Luos_TxComplete(void);
 void Luos_Flush(void);
 
@@ -35,7 +35,7 @@ typedef enum
 typedef enum
 {
     // Luos specific registers
-    RTB_CMD = ROBUS_PROTOCOL_NB, // Ask(size == 0), generate(size == 2), or share(size > 2) a routing_table.
+    RTB_CMD = ROBUS_PROTOCOL_NB, // Ask(size == 0), generate(size == 2), or share(size > 2) a local routing_table.
     WRITE_ALIAS,                 // Get and save a new given alias.
     UPDATE_PUB,                  // Ask to update a sensor value each time duration to the sender
     NODE_UUID,                   // luos_uuid_t
@@ -106,6 +106,11 @@ typedef enum
     PARAMETERS,         // depend on the container, can be : servo_parameters_t, imu_report_t, motor_mode_t
 
     // compatibility area
+    RTB_SHARE,        // Broadcast a complete routing_table using compact frames.
+    RTB_DELTA,        // Broadcast a routing_table modification.
+    RTB_EPOCH,        // Acknowledge a routing_table modification with the routing_table epoch.
+    STREAM_REDUCTION, // stream_reduction_t, reduction applied by a streaming source
+    STREAM_CREDIT,    // uint32_t, number of samples a streaming receiver allows to send since the start
     LUOS_PROTOCOL_NB,
 } luos_cmd_t;
 
@@ -47,5 +47,6 @@ typedef struct __attribute__((__packed__))
 
 void Luos_assert(char *file, uint32_t line);
 void node_assert(char *file, uint32_t line);
+void node_wakeup(void);
 
 #endif /* LUOS_UTILS_H */
\ No newline at end of file
@@ -11,7 +11,29 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
-#define MAX_RTB_ENTRY 40
+// Routing table capacity. Gateways can increase those values to manage big networks.
+#ifndef MAX_RTB_CONTAINER
+#define MAX_RTB_CONTAINER 40
+#endif
+
+#ifndef MAX_RTB_NODE
+#define MAX_RTB_NODE 20
+#endif
+
+// Number of ports saved for each node, increase it if some nodes of the network have more ports than this one.
+#ifndef MAX_RTB_NODE_PORT
+#define MAX_RTB_NODE_PORT NBR_PORT
+#endif
+
+// Size in bytes of the memory used to store aliases. Identical aliases bases are stored only once.
+#ifndef RTB_ALIAS_POOL_SIZE
+#define RTB_ALIAS_POOL_SIZE (MAX_RTB_CONTAINER * 8)
+#endif
+
+// Number of slots of the alias pool hash table, should be bigger than the number of different aliases.
+#ifndef RTB_ALIAS_HASH_SIZE
+#define RTB_ALIAS_HASH_SIZE (MAX_RTB_CONTAINER * 2)
+#endif
 
 typedef enum
 {
@@ -23,8 +45,9 @@ typedef enum
  * Variables
  ******************************************************************************/
 
-/* This structure is used to receive or send messages between containers in slave
- * and master mode.
+/* This structure is the exchange format of a routing_table entry.
+ * It is used to send or receive routing tables between nodes and to read the
+ * routing_table content (see RoutingTB_GetEntry).
  * please refer to the documentation
  */
 typedef struct __attribute__((__packed__))
@@ -55,11 +78,58 @@ typedef struct __attribute__((__packed__))
     };
 } routing_table_t;
 
+/* This structure is used to store a container into the routing_table.
+ * The alias is stored as a base string into the alias pool and a number added at the end of it.
+ */
+typedef struct __attribute__((__packed__))
+{
+    uint16_t id;           // Container ID.
+    uint16_t type;         // Container type.
+    uint16_t alias;        // Position of the alias base into the alias pool.
+    uint16_t alias_suffix; // Number added at the end of the alias base (0 for none).
+} rtb_container_t;
+
+/* This structure is used to store a node into the routing_table.
+ * Containers of a node are stored from first_container to the first_container of the next node.
+ */
+typedef struct __attribute__((__packed__))
+{
+    struct __attribute__((__packed__))
+    {
+        uint16_t node_id : 12;  // Node id
+        uint16_t certified : 4; // True if the node have a certificate
+    };
+    uint16_t port_table[MAX_RTB_NODE_PORT]; // Node link table
+    uint16_t first_container;               // Index of the first container of this node
+} rtb_node_t;
+
+/* This structure is used to walk through a precomputed list of containers
+ * matching a search (all containers of a type, of a node, all sensors...).
+ * please refer to the documentation
+ */
+typedef struct
+{
+    const uint16_t *list; // Precomputed list of container indexes, NULL if containers are contiguous
+    uint16_t first;       // Index of the first container if list is NULL
+    uint16_t nb;          // Number of containers in the list
+    uint16_t cursor;      // Position of the next container to return
+} rtb_iterator_t;
+
+/* This structure is used to keep the result of an alias search until the routing_table change.
+ * please refer to the documentation
+ */
+typedef struct
+{
+    uint16_t version; // Routing_table version of the cached id (0 to force a search)
+    uint16_t id;      // Cached container ID
+} rtb_id_cache_t;
+
 /*******************************************************************************
  * Function
  ******************************************************************************/
 // ********************* routing_table search tools ************************
 uint16_t RoutingTB_IDFromAlias(char *alias);
+uint16_t RoutingTB_IDFromAliasCached(rtb_id_cache_t *cache, char *alias);
 uint16_t RoutingTB_IDFromType(luos_type_t type);
 uint16_t RoutingTB_IDFromContainer(container_t *container);
 char *RoutingTB_AliasFromId(uint16_t id);
@@ -70,17 +140,36 @@ uint8_t RoutingTB_ContainerIsSensor(luos_type_t type);
 uint16_t RoutingTB_GetNodeNB(void);
 uint16_t RoutingTB_GetNodeID(uint16_t index);
 
+// ********************* routing_table iterators ************************
+rtb_iterator_t RoutingTB_IterateType(luos_type_t type);
+rtb_iterator_t RoutingTB_IterateNode(uint16_t node_id);
+rtb_iterator_t RoutingTB_IterateSensors(void);
+uint16_t RoutingTB_IteratorNext(rtb_iterator_t *iterator);
+
 // ********************* routing_table management tools ************************
 void RoutingTB_ComputeRoutingTableEntryNB(void);
 void RoutingTB_DetectContainers(container_t *container);
+void RoutingTB_StartDetection(container_t *container);
+error_return_t RoutingTB_DetectionComplete(void);
 void RoutingTB_ConvertNodeToRoutingTable(routing_table_t *entry, node_t *node);
 void RoutingTB_ConvertContainerToRoutingTable(routing_table_t *entry, container_t *container);
 void RoutingTB_RemoveNode(uint16_t nodeid);
 void RoutingTB_RemoveOnRoutingTable(uint16_t id);
 void RoutingTB_Erase(void);
-routing_table_t *RoutingTB_Get(void);
+error_return_t RoutingTB_AddEntry(const routing_table_t *entry);
+error_return_t RoutingTB_ReceiveEntries(msg_t *msg);
+error_return_t RoutingTB_ReceiveFrame(msg_t *msg);
+uint16_t RoutingTB_GetEpoch(void);
+error_return_t RoutingTB_DeltaAdd(container_t *container, uint16_t node_id, uint16_t id, luos_type_t type, char *alias);
+error_return_t RoutingTB_DeltaRemove(container_t *container, uint16_t id);
+error_return_t RoutingTB_DeltaRename(container_t *container, uint16_t id, char *alias);
+error_return_t RoutingTB_ReceiveDelta(container_t *container, msg_t *msg);
+void RoutingTB_ReceiveEpoch(container_t *container, msg_t *msg);
+error_return_t RoutingTB_GetEntry(uint16_t index, routing_table_t *entry);
 uint16_t RoutingTB_GetLastContainer(void);
 uint16_t *RoutingTB_GetLastNode(void);
 uint16_t RoutingTB_GetLastEntry(void);
+uint16_t RoutingTB_GetMissingAliasNB(void);
+routing_table_t *RoutingTB_Get(void) __attribute__((deprecated("use RoutingTB_GetEntry")));
 
 #endif /* TABLE */
@@ -4,12 +4,45 @@
  *
  *  Streaming channel
  *  This structure manage a ring buffer as a streaming channel.
- * 
- *   |--------------------- ring_buffer_size --------------------|
- *   |*****************|...............|                         |
- *   ^                 ^               ^                         ^
- * ring_buffer    sample_ptr       data_ptr               end_ring_buffer
- * 
+ *  It is safe to use with one producer (IRQ) and one consumer (loop) without critical sections.
+ *
+ *   |----------------- ring_buffer_size (power of 2) ------------------|
+ *   |...............|*******************************|..................|
+ *   ^               ^                               ^
+ * ring_buffer  tail & mask                     head & mask
+ *
+ *  head and tail are monotonic sample counters, head - tail is the number of available samples.
+ *
+ *  Samples can be accessed in place using spans. Because of the ring wrap, a
+ *  region of the ring buffer is described by at most 2 contiguous spans:
+ *  Stream_PeekSpans/Stream_CommitRead on the consumer side and
+ *  Stream_ReserveSpans/Stream_CommitWrite on the producer side.
+ *
+ *  Broadcast channels share the same ring buffer between one producer and any
+ *  number of stream_reader_t, each reader having its own cursor. The producer
+ *  is never held by the readers, it overwrites the oldest samples and a reader
+ *  lapped by the producer skips the lost samples and counts them as overrun.
+ *
+ *  A channel with a stream_timing_t sends a stream_frame_t before the samples
+ *  of each message, giving the date of the first sample, the sample period and
+ *  a sequence number. The receiver uses it to detect lost frames and can
+ *  linearly resample the stream to its own period.
+ *
+ *  A channel with a stream_reducer_t reduces the samples put by the producer
+ *  before storing them (decimation, windowed min/max/mean/RMS or low-pass),
+ *  so the ring buffer and the bus only carry what the consumers need. A new
+ *  reduction configuration is applied by the producer itself at the end of
+ *  the current window, the producer can keep putting samples from an IRQ.
+ *
+ *  Channels of integer values can be sent using a codec. Each message then
+ *  starts with a codec byte and a sample number, followed by the samples as
+ *  stored or by the zigzag varint of the delta of each value with the same
+ *  value of the previous sample, whichever carries more samples.
+ *
+ *  A channel with a stream_credit_t is flow controlled. The receiver
+ *  periodically grants the number of samples it can store since the start and
+ *  the sender never sends more than granted.
+ *
  * @author Luos
  * @version 0.0.0
  ******************************************************************************/
@@ -17,17 +50,107 @@
 #define STREAMING_H
 
 #include <stdint.h>
+#include "robus_struct.h"
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+#ifndef MAX_STREAM_VALUES
+#define MAX_STREAM_VALUES 4 // Maximum number of values in a resampled, reduced or encoded sample
+#endif
+#define STREAM_CODEC_HEADER_SIZE 2 // Codec byte and sample number of an encoded message
+
+typedef enum
+{
+    STREAM_CODEC_RAW,   // Samples are sent as stored
+    STREAM_CODEC_DELTA, // Values are sent as zigzag varint of their delta with the previous sample
+} stream_codec_t;
+
+typedef enum
+{
+    STREAM_RAW,      // Samples are stored as put
+    STREAM_DECIMATE, // Keep one sample every factor samples
+    STREAM_MIN,      // Minimum of each window of factor samples
+    STREAM_MAX,      // Maximum of each window of factor samples
+    STREAM_MEAN,     // Mean of each window of factor samples
+    STREAM_RMS,      // Root mean square of each window of factor samples
+    STREAM_LOWPASS,  // First order low-pass filter, decimated by factor
+    STREAM_REDUCTION_NB
+} stream_reduction_mode_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint8_t mode;    // stream_reduction_mode_t
+    uint16_t factor; // Number of put samples for one stored sample
+    float alpha;     // Low-pass filter coefficient, between 0 and 1
+} stream_reduction_t;
+
 typedef struct
 {
-    void *ring_buffer;     // Begin ring buffer pointer
-    void *end_ring_buffer; // End of the ring buffer
-    void *sample_ptr;      // Current sample pointer (pointer always point a fresh data)
-    void *data_ptr;        // Current pointer of data
-    uint8_t data_size;     // Size granulariry of the data contained on the ring buffer
+    stream_reduction_t reduction; // Current reduction configuration
+    uint16_t count;               // Number of samples accumulated in the current window
+    uint8_t primed;               // True if the low-pass filter got its first sample
+    float acc[MAX_STREAM_VALUES]; // Accumulated values of the current window
+    stream_reduction_t next;      // Configuration the producer apply at the end of the current window
+    volatile uint8_t next_ready;  // True if next is waiting to be applied, set by the consumer and cleared by the producer
+    volatile uint8_t switched;    // True if the producer applied next, set by the producer and cleared by the consumer
+    uint32_t switch_head;         // Head of the channel when next have been applied
+    uint16_t switch_factor;       // Factor of the configuration replaced by next
+} stream_reducer_t;
+
+typedef struct
+{
+    uint32_t count; // Sender: number of samples sent, receiver: number of samples received
+    uint32_t limit; // Number of samples the sender is allowed to send since the start
+} stream_credit_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint8_t seq;        // Frame sequence number
+    uint32_t timestamp; // Date of the first sample of the frame in us
+    uint32_t period;    // Period between two samples in us
+} stream_frame_t;
+
+typedef struct
+{
+    uint32_t origin;               // Sample counter of the origin sample
+    uint32_t origin_date;          // Date of the origin sample in us
+    uint32_t period;               // Sender: sample period, receiver: resampling period (0 to disable) in us
+    uint8_t seq;                   // Sequence number of the next frame
+    uint8_t receiving;             // True if the receiver already got a frame
+    uint32_t lost_frame;           // Number of frames lost by the receiver
+    uint32_t next_date;            // Date of the next resampled sample in us
+    uint32_t prev_date;            // Date of the last received sample in us
+    uint32_t frame_period;         // Receiver: period of the received samples in us
+    float prev[MAX_STREAM_VALUES]; // Last received sample
+} stream_timing_t;
+typedef struct
+{
+    void *ring_buffer;            // Begin ring buffer pointer
+    uint32_t mask;                // Ring buffer size in samples minus one
+    volatile uint32_t head;       // Number of samples ever written, only modified by the producer
+    volatile uint32_t tail;       // Number of samples ever read, only modified by the consumer
+    volatile uint32_t write_head; // Number of samples ever written or being written, only used by broadcast channels
+    uint8_t data_size;            // Size granulariry of the data contained on the ring buffer
+    uint8_t broadcast;            // True if the channel is read by stream_reader_t
+    stream_timing_t *timing;      // Frame informations, NULL to send bare samples
+    stream_reducer_t *reducer;    // Reduction applied to put samples, NULL to store them as put
+    uint8_t codec;                // Size of the integer values of a sample for the delta codec, 0 to send samples as stored
+    stream_credit_t *credit;      // Credit based flow control, NULL to disable it
+    uint32_t drop_nb;             // Number of samples dropped because the ring buffer was full
 } streaming_channel_t;
+
+typedef struct
+{
+    streaming_channel_t *stream; // Broadcast channel read by this reader
+    uint32_t tail;               // Number of samples read by this reader
+    uint32_t overrun;            // Number of samples overwritten by the producer before this reader read them
+} stream_reader_t;
+
+typedef struct
+{
+    void *data;    // Begin of the contiguous samples in the ring buffer
+    uint16_t size; // Number of contiguous samples
+} stream_span_t;
 /*******************************************************************************
  * Variables
  ******************************************************************************/
@@ -36,9 +159,29 @@ typedef struct
  * Function
  ******************************************************************************/
 streaming_channel_t Stream_CreateStreamingChannel(const void *ring_buffer, uint16_t ring_buffer_size, uint8_t data_size);
+streaming_channel_t Stream_CreateBroadcastChannel(const void *ring_buffer, uint16_t ring_buffer_size, uint8_t data_size);
 void Stream_ResetStreamingChannel(streaming_channel_t *stream);
-uint8_t Stream_PutSample(streaming_channel_t *stream, const void *data, uint16_t size);
-uint8_t Stream_GetSample(streaming_channel_t *stream, void *data, uint16_t size);
-uint8_t Stream_GetAvailableSampleNB(streaming_channel_t *stream);
+uint16_t Stream_PutSample(streaming_channel_t *stream, const void *data, uint16_t size);
+uint16_t Stream_GetSample(streaming_channel_t *stream, void *data, uint16_t size);
+uint16_t Stream_GetAvailableSampleNB(streaming_channel_t *stream);
+uint16_t Stream_PeekSpans(streaming_channel_t *stream, stream_span_t spans[2]);
+void Stream_CommitRead(streaming_channel_t *stream, uint16_t size);
+uint16_t Stream_ReserveSpans(streaming_channel_t *stream, stream_span_t spans[2]);
+void Stream_CommitWrite(streaming_channel_t *stream, uint16_t size);
+stream_reader_t Stream_CreateReader(streaming_channel_t *stream);
+uint16_t Stream_ReaderGetSample(stream_reader_t *reader, void *data, uint16_t size);
+uint16_t Stream_ReaderGetAvailableSampleNB(stream_reader_t *reader);
+void Stream_SetSampling(streaming_channel_t *stream, stream_timing_t *timing, uint32_t date, uint32_t period);
+void Stream_SetResampling(streaming_channel_t *stream, stream_timing_t *timing, uint32_t period);
+void Stream_MakeFrame(streaming_channel_t *stream, stream_frame_t *frame);
+void Stream_PutFrame(streaming_channel_t *stream, const stream_frame_t *frame, const void *data, uint16_t size);
+void Stream_SetCodec(streaming_channel_t *stream, uint8_t value_size);
+uint16_t Stream_EncodeSample(streaming_channel_t *stream, void *data, uint16_t size, uint16_t *sample_nb);
+uint16_t Stream_DecodeSample(streaming_channel_t *stream, const stream_frame_t *frame, const void *data, uint16_t size);
+error_return_t Stream_SetReduction(streaming_channel_t *stream, stream_reducer_t *reducer, const stream_reduction_t *reduction);
+void Stream_SetCredit(streaming_channel_t *stream, stream_credit_t *credit);
+void Stream_GrantCredit(streaming_channel_t *stream, uint32_t limit);
+uint16_t Stream_GetCredit(streaming_channel_t *stream);
+uint32_t Stream_ComputeGrant(streaming_channel_t *stream);
 
 #endif /* LUOS_H */
@@ -14,6 +14,12 @@
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+// Timed update periods are stored in ms on 16 bits, longer periods are clamped to this one
+#ifdef OD_FIXED_POINT
+#define MAX_UPDATE_PERIOD OD_FIXED(65.535)
+#else
+#define MAX_UPDATE_PERIOD 65.535f
+#endif
 
 /*******************************************************************************
  * Variables
@@ -25,6 +31,24 @@ volatile routing_table_t *routing_table_pt;
 
 luos_stats_t luos_stats;
 general_stats_t general_stats;
+
+// Timed update min-heap ordered by next_update date
+timed_update_t timed_update_heap[MAX_TIMED_UPDATE];
+uint16_t timed_update_number;
+timed_update_t *publishing_update = NULL;
+
+// Timers min-heap ordered by deadline
+luos_timer_t *timer_heap[MAX_LUOS_TIMER];
+uint16_t timer_number;
+uint32_t idle_time_ms = 0;
+
+// Cooperative tasks
+luos_task_t *task_table[MAX_LUOS_TASK];
+uint16_t task_number;
+
+// Requests waiting for their reply, sorted by request date
+luos_request_t request_table[MAX_LUOS_REQUEST];
+uint16_t request_number;
 /*******************************************************************************
  * Function
  ******************************************************************************/
@@ -33,10 +57,28 @@ static container_t *Luos_GetContainer(ll_container_t *ll_container);
 static uint16_t Luos_GetContainerIndex(container_t *container);
 static void Luos_TransmitLocalRoutingTable(container_t *container, msg_t *routeTB_msg);
 static void Luos_AutoUpdateManager(void);
+static void Luos_SubscribeUpdate(container_t *container, uint16_t target, update_pub_t *sub, uint8_t on_change);
+static uint16_t Luos_PeriodToMs(time_luos_t period);
+static error_return_t Luos_UpdateValueChanged(timed_update_t *update, msg_t *msg);
+static void Luos_SiftUpdate(uint16_t index);
+static void Luos_RemoveUpdate(uint16_t index);
+static uint8_t Luos_TimerManager(void);
+static void Luos_SiftTimer(uint16_t index);
+static void Luos_SendEncodedStreaming(container_t *container, msg_t *msg, streaming_channel_t *stream, uint16_t frame_size, uint16_t data_size);
 static error_return_t Luos_SaveAlias(container_t *container, uint8_t *alias);
 static void Luos_WriteAlias(uint16_t local_id, uint8_t *alias);
 static error_return_t Luos_ReadAlias(uint16_t local_id, uint8_t *alias);
 static error_return_t Luos_IsALuosCmd(container_t *container, uint8_t cmd, uint16_t size);
+static error_return_t Luos_HaveCallback(container_t *container);
+static void Luos_DispatchMsg(container_t *container, msg_t *msg);
+static uint8_t Luos_BatchManager(void);
+static luos_task_t *Luos_TaskWaitingFor(container_t *container, uint16_t source, uint8_t cmd);
+static void Luos_TaskRun(luos_task_t *task);
+static uint8_t Luos_TaskManager(void);
+static uint16_t Luos_RequestWaitingFor(container_t *container, uint16_t source, uint8_t cmd);
+static void Luos_RequestEnd(uint16_t index, msg_t *reply_msg);
+static uint8_t Luos_RequestManager(void);
+static void Luos_UpdateCmdFilter(container_t *container);
 
 /******************************************************************************
  * @brief Luos init must be call in project init
@@ -45,7 +87,11 @@ static error_return_t Luos_IsALuosCmd(container_t *container, uint8_t cmd, uint1
  ******************************************************************************/
 void Luos_Init(void)
 {
-    container_number = 0;
+    container_number    = 0;
+    timed_update_number = 0;
+    timer_number        = 0;
+    task_number         = 0;
+    request_number      = 0;
     memset(&luos_stats.unmap[0], 0, sizeof(luos_stats_t));
     Robus_Init(&luos_stats.memory);
 }
@@ -57,15 +103,22 @@ void Luos_Init(void)
 void Luos_Loop(void)
 {
     static uint32_t last_loop_date;
+    static uint8_t last_loop_idle;
     uint16_t remaining_msg_number       = 0;
     ll_container_t *oldest_ll_container = NULL;
     msg_t *returned_msg                 = NULL;
+    uint8_t idle                        = true;
 
     // check loop call time stat
     if ((LuosHAL_GetSystick() - last_loop_date) > luos_stats.max_loop_time_ms)
     {
         luos_stats.max_loop_time_ms = LuosHAL_GetSystick() - last_loop_date;
     }
+    if (last_loop_idle)
+    {
+        // Nothing happened since the last loop, count this time as idle
+        idle_time_ms += LuosHAL_GetSystick() - last_loop_date;
+    }
     Robus_Loop();
     // look at all received messages
     while (MsgAlloc_LookAtLuosTask(remaining_msg_number, &oldest_ll_container) != FAILED)
@@ -73,10 +126,12 @@ void Luos_Loop(void)
         // There is a message available find the container linked to it
         container_t *container = Luos_GetContainer(oldest_ll_container);
         // check if this is a Luos Command
-        uint8_t cmd   = 0;
-        uint16_t size = 0;
+        uint8_t cmd     = 0;
+        uint16_t size   = 0;
+        uint16_t source = 0;
         // There is a possibility to receive in IT a restet_detection so check task before doing any treatement
-        if ((MsgAlloc_GetLuosTaskCmd(remaining_msg_number, &cmd) != SUCCEED) || (MsgAlloc_GetLuosTaskSize(remaining_msg_number, &size) != SUCCEED))
+        if ((MsgAlloc_GetLuosTaskCmd(remaining_msg_number, &cmd) != SUCCEED) || (MsgAlloc_GetLuosTaskSize(remaining_msg_number, &size) != SUCCEED)
+            || (MsgAlloc_GetLuosTaskSourceId(remaining_msg_number, &source) != SUCCEED))
         {
             break;
         }
@@ -85,6 +140,7 @@ void Luos_Loop(void)
         {
             if (MsgAlloc_PullMsgFromLuosTask(remaining_msg_number, &returned_msg) == SUCCEED)
             {
+                idle = false;
                 // be sure the content of this message need to be managed by Luos and do it if it is.
                 if (Luos_MsgHandler((container_t *)container, returned_msg) == SUCCEED)
                 {
@@ -95,36 +151,79 @@ void Luos_Loop(void)
                 else
                 {
                     // Here we should not have polling modules.
-                    LUOS_ASSERT(container->cont_cb != 0);
+                    LUOS_ASSERT(Luos_HaveCallback(container) == SUCCEED);
                     // This message is for the user, pass it to the user.
-                    container->cont_cb(container, returned_msg);
+                    Luos_DispatchMsg(container, returned_msg);
                 }
             }
         }
         else
         {
             // This message is for a container
+            // check if this is the reply of a request or if a task of this container is waiting for it
+            uint16_t request  = Luos_RequestWaitingFor(container, source, cmd);
+            luos_task_t *task = Luos_TaskWaitingFor(container, source, cmd);
+            if (request < request_number)
+            {
+                if (MsgAlloc_PullMsgFromLuosTask(remaining_msg_number, &returned_msg) == SUCCEED)
+                {
+                    idle = false;
+                    Luos_RequestEnd(request, returned_msg);
+                }
+            }
+            else if (task != NULL)
+            {
+                if (MsgAlloc_PullMsgFromLuosTask(remaining_msg_number, &returned_msg) == SUCCEED)
+                {
+                    idle      = false;
+                    task->msg = returned_msg;
+                    Luos_TaskRun(task);
+                }
+            }
             // check if this continer have a callback?
-            if (container->cont_cb != 0)
+            else if ((container->batch_cb == 0) && (Luos_HaveCallback(container) == SUCCEED))
             {
                 // This container have a callback pull the message
                 if (MsgAlloc_PullMsgFromLuosTask(remaining_msg_number, &returned_msg) == SUCCEED)
                 {
+                    idle = false;
                     // This message is for the user, pass it to the user.
-                    container->cont_cb(container, returned_msg);
+                    Luos_DispatchMsg(container, returned_msg);
                 }
             }
             else
             {
+                // Polling and batch containers messages are managed later
                 remaining_msg_number++;
             }
         }
     }
+    // give pending messages to batch containers
+    if (Luos_BatchManager())
+    {
+        idle = false;
+    }
+    // run ready tasks
+    if (Luos_TaskManager())
+    {
+        idle = false;
+    }
+    // time out requests without reply
+    if (Luos_RequestManager())
+    {
+        idle = false;
+    }
     // finish msg used
     MsgAlloc_UsedMsgEnd();
     // manage timed auto update
     Luos_AutoUpdateManager();
+    // call expired timers
+    if (Luos_TimerManager())
+    {
+        idle = false;
+    }
     // save loop date
+    last_loop_idle = idle;
     last_loop_date = LuosHAL_GetSystick();
 }
 /******************************************************************************
@@ -134,6 +233,11 @@ void Luos_Loop(void)
  ******************************************************************************/
 static error_return_t Luos_IsALuosCmd(container_t *container, uint8_t cmd, uint16_t size)
 {
+    if ((cmd >= ASK_PUB_CMD) && ((cmd < RTB_SHARE) || (cmd > RTB_EPOCH)))
+    {
+        // This is a container command
+        return FAILED;
+    }
     switch (cmd)
     {
         case WRITE_NODE_ID:
@@ -143,7 +247,7 @@ static error_return_t Luos_IsALuosCmd(container_t *container, uint8_t cmd, uint1
             LUOS_ASSERT(0);
             break;
         case ASSERT:
-            if (container->cont_cb != 0)
+            if (Luos_HaveCallback(container) == SUCCEED)
             {
                 return SUCCEED;
             }
@@ -153,6 +257,9 @@ static error_return_t Luos_IsALuosCmd(container_t *container, uint8_t cmd, uint1
             }
             break;
         case RTB_CMD:
+        case RTB_SHARE:
+        case RTB_DELTA:
+        case RTB_EPOCH:
         case WRITE_ALIAS:
         case UPDATE_PUB:
             return SUCCEED;
@@ -173,6 +280,95 @@ static error_return_t Luos_IsALuosCmd(container_t *container, uint8_t cmd, uint1
     }
     return FAILED;
 }
+/******************************************************************************
+ * @brief Check if a container get its messages using a callback or a dispatch table
+ * @param container
+ * @return SUCCEED if the container messages can be dispatched
+ ******************************************************************************/
+static error_return_t Luos_HaveCallback(container_t *container)
+{
+    if ((container->cont_cb != 0) || (container->dispatch != 0) || (container->batch_cb != 0))
+    {
+        return SUCCEED;
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief Give a message to the container handler managing it
+ * If the container have a dispatch table, commands not registered into it are dropped.
+ * @param container
+ * @param msg to give
+ * @return None
+ ******************************************************************************/
+static void Luos_DispatchMsg(container_t *container, msg_t *msg)
+{
+    if ((container->dispatch == 0) && (container->cont_cb == 0))
+    {
+        // Only a batch callback, give it this message alone
+        container->batch_cb(container, &msg, 1);
+        return;
+    }
+    if (container->dispatch == 0)
+    {
+        container->cont_cb(container, msg);
+        return;
+    }
+    // Find the range of the command (entries are sorted by command)
+    const luos_dispatch_table_t *dispatch = container->dispatch;
+    uint16_t first                        = 0;
+    uint16_t last                         = dispatch->nb;
+    while (first < last)
+    {
+        uint16_t middle = (first + last) / 2;
+        if (dispatch->entries[middle].last_cmd < msg->header.cmd)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    if ((first < dispatch->nb) && (dispatch->entries[first].first_cmd <= msg->header.cmd))
+    {
+        dispatch->entries[first].handler(container, msg);
+    }
+}
+/******************************************************************************
+ * @brief Give all pending messages of batch containers to their batch callback
+ * Messages not consumed by a batch callback stay pending for the next loop.
+ * @param None
+ * @return true if at least a message have been consumed
+ ******************************************************************************/
+static uint8_t Luos_BatchManager(void)
+{
+    uint8_t consumed = false;
+    msg_t *batch[MAX_MSG_NB];
+    for (uint16_t i = 0; i < container_number; i++)
+    {
+        if (container_table[i].batch_cb == 0)
+        {
+            continue;
+        }
+        uint16_t nb                     = MsgAlloc_GatherMsg(container_table[i].ll_container, batch, MAX_MSG_NB);
+        container_table[i].batch_held_nb = 0;
+        if (nb == 0)
+        {
+            continue;
+        }
+        uint16_t consumed_nb = container_table[i].batch_cb(&container_table[i], batch, nb);
+        LUOS_ASSERT(consumed_nb <= nb);
+        container_table[i].batch_held_nb = nb - consumed_nb;
+        // Remove consumed messages, they are the oldest ones
+        for (uint16_t j = 0; j < consumed_nb; j++)
+        {
+            msg_t *msg;
+            MsgAlloc_PullMsg(container_table[i].ll_container, &msg);
+            consumed = true;
+        }
+    }
+    return consumed;
+}
 /******************************************************************************
  * @brief handling msg for Luos library
  * @param container
@@ -184,8 +380,8 @@ static error_return_t Luos_MsgHandler(container_t *container, msg_t *input)
 {
     error_return_t consume = FAILED;
     msg_t output_msg;
-    routing_table_t *route_tab = &RoutingTB_Get()[RoutingTB_GetLastEntry()];
-    time_luos_t time;
+    time_luos_t time = 0;
+    update_pub_t sub;
     uint16_t base_id = 0;
 
     switch (input->header.cmd)
@@ -200,7 +396,7 @@ static error_return_t Luos_MsgHandler(container_t *container, msg_t *input)
             // Depending on the size of this message we have to make different operations
             // If size is 0 someone ask to get local_route table back
             // If size is 2 someone ask us to generate a local route table based on the given container ID then send local route table back.
-            // If size is bigger than 2 this is a complete routing table comming. We have to save it.
+            // If size is bigger than 2 this is a local routing table comming during detection. We have to save it.
             switch (input->header.size)
             {
                 case 2:
@@ -237,17 +433,27 @@ static error_return_t Luos_MsgHandler(container_t *container, msg_t *input)
                     Luos_TransmitLocalRoutingTable(container, &output_msg);
                     break;
                 default:
-                    // Check routing table overflow
-                    LUOS_ASSERT(((uint32_t)route_tab + input->header.size) <= ((uint32_t)RoutingTB_Get() + (sizeof(routing_table_t) * MAX_RTB_ENTRY)));
-                    if (Luos_ReceiveData(container, input, (void *)route_tab) == SUCCEED)
-                    {
-                        // route table section reception complete
-                        RoutingTB_ComputeRoutingTableEntryNB();
-                    }
+                    // Add the received entries into the routing table, entries overflowing it are dropped.
+                    RoutingTB_ReceiveEntries(input);
                     break;
             }
             consume = SUCCEED;
             break;
+        case RTB_SHARE:
+            // A complete routing table frame is comming, entries overflowing it are dropped.
+            RoutingTB_ReceiveFrame(input);
+            consume = SUCCEED;
+            break;
+        case RTB_DELTA:
+            // A routing table modification is comming, apply it and acknowledge it.
+            RoutingTB_ReceiveDelta(container, input);
+            consume = SUCCEED;
+            break;
+        case RTB_EPOCH:
+            // A node acknowledge our routing table modification.
+            RoutingTB_ReceiveEpoch(container, input);
+            consume = SUCCEED;
+            break;
         case REVISION:
             if (input->header.size == 0)
             {
@@ -334,15 +540,34 @@ static error_return_t Luos_MsgHandler(container_t *container, msg_t *input)
                 Luos_SaveAlias(container, '\0');
                 memcpy(container->alias, container->default_alias, MAX_ALIAS_SIZE);
             }
+            if (RoutingTB_GetLastEntry() != 0)
+            {
+                // Update this alias on all routing tables
+                RoutingTB_DeltaRename(container, container->ll_container->id, (char *)container->alias);
+            }
             consume = SUCCEED;
             break;
         case UPDATE_PUB:
             // this container need to be auto updated
-            TimeOD_TimeFromMsg(&time, input);
-            container->auto_refresh.target      = input->header.source;
-            container->auto_refresh.time_ms     = (uint16_t)TimeOD_TimeTo_ms(time);
-            container->auto_refresh.last_update = LuosHAL_GetSystick();
-            consume                             = SUCCEED;
+            if (input->header.size >= sizeof(update_pub_t))
+            {
+                // Publish only on value changes
+                // Fields are float32 on the wire
+                sub.min_period = OD_ValueFromFloat32(&input->data[0]);
+                sub.max_period = OD_ValueFromFloat32(&input->data[sizeof(time_luos_t)]);
+                sub.deadband   = OD_ValueFromFloat32(&input->data[2 * sizeof(time_luos_t)]);
+                Luos_SubscribeUpdate(container, input->header.source, &sub, true);
+            }
+            else
+            {
+                // Publish periodically, a payload of an unknown size unsubscribe
+                TimeOD_TimeFromMsg(&time, input);
+                sub.min_period = time;
+                sub.max_period = 0;
+                sub.deadband   = 0;
+                Luos_SubscribeUpdate(container, input->header.source, &sub, false);
+            }
+            consume = SUCCEED;
             break;
         default:
             break;
@@ -356,11 +581,13 @@ static error_return_t Luos_MsgHandler(container_t *container, msg_t *input)
  ******************************************************************************/
 static container_t *Luos_GetContainer(ll_container_t *ll_container)
 {
-    for (uint16_t i = 0; i < container_number; i++)
+    // container_table and ll_container table are parallels (see Luos_CreateContainer)
+    if ((container_number != 0) && (ll_container >= container_table[0].ll_container))
     {
-        if (ll_container == container_table[i].ll_container)
+        uint16_t index = (uint16_t)(ll_container - container_table[0].ll_container);
+        if (index < container_number)
         {
-            return &container_table[i];
+            return &container_table[index];
         }
     }
     return 0;
@@ -372,12 +599,9 @@ static container_t *Luos_GetContainer(ll_container_t *ll_container)
  ******************************************************************************/
 static uint16_t Luos_GetContainerIndex(container_t *container)
 {
-    for (uint16_t i = 0; i < container_number; i++)
+    if ((container >= container_table) && (container < &container_table[container_number]))
     {
-        if (container == &container_table[i])
-        {
-            return i;
-        }
+        return (uint16_t)(container - container_table);
     }
     return 0xFFFF;
 }
@@ -402,53 +626,305 @@ static void Luos_TransmitLocalRoutingTable(container_t *container, msg_t *routeT
     Luos_SendData(container, routeTB_msg, (void *)local_routing_table, (entry_nb * sizeof(routing_table_t)));
 }
 /******************************************************************************
- * @brief auto update publication for container
- * @param none
- * @return none
+ * @brief Publish all expired timed updates
+ * Timed updates are sorted by date, only expired ones are looked at.
+ * @param None
+ * @return None
  ******************************************************************************/
 static void Luos_AutoUpdateManager(void)
 {
-    // check all containers timed_update_t contexts
-    for (uint16_t i = 0; i < container_number; i++)
+    if (timed_update_number == 0)
     {
-        // check if containers have an actual ID. If not, we are in detection mode and should reset the auto refresh
-        if (container_table[i].ll_container->id == DEFAULTID)
+        return;
+    }
+    if (Robus_GetNode()->node_id == DEFAULTID)
+    {
+        // We are in detection mode, all subscribers IDs will change. Remove all timed updates.
+        timed_update_number = 0;
+        return;
+    }
+    while ((timed_update_number > 0) && ((int32_t)(LuosHAL_GetSystick() - timed_update_heap[0].next_update) >= 0))
+    {
+        timed_update_t *update = &timed_update_heap[0];
+        container_t *container = &container_table[update->container_index];
+        // This container need to send an update
+        // Create a fake message for it from the first subscriber asking for update
+        msg_t updt_msg;
+        updt_msg.header.target      = container->ll_container->id;
+        updt_msg.header.source      = update->target[0];
+        updt_msg.header.target_mode = IDACK;
+        updt_msg.header.cmd         = ASK_PUB_CMD;
+        updt_msg.header.size        = 0;
+        if (Luos_HaveCallback(container) == SUCCEED)
         {
-            // this container have not been detected or is in detection mode. remove auto_refresh parameters
-            container_table[i].auto_refresh.target      = 0;
-            container_table[i].auto_refresh.time_ms     = 0;
-            container_table[i].auto_refresh.last_update = 0;
+            // The reply to the first subscriber will be sent to all of them (see Luos_SendMsg)
+            publishing_update = update;
+            Luos_DispatchMsg(container, &updt_msg);
+            publishing_update = NULL;
         }
         else
         {
-            // check if there is a timed update setted and if it's time to update it.
-            if (container_table[i].auto_refresh.time_ms)
+            //store container and msg pointer
+            // todo this can't work for now because this message is not permanent.
+            //mngr_set(container, &updt_msg);
+        }
+        // Schedule the next publication
+        update->next_update = LuosHAL_GetSystick() + update->time_ms;
+        Luos_SiftUpdate(0);
+    }
+}
+/******************************************************************************
+ * @brief Add, move or remove a subscriber of a container timed update
+ * @param container publishing the update
+ * @param target ID of the subscriber
+ * @param sub subscription parameters, a null min_period unsubscribe
+ * @param on_change true to publish only values changing
+ * @return None
+ ******************************************************************************/
+static void Luos_SubscribeUpdate(container_t *container, uint16_t target, update_pub_t *sub, uint8_t on_change)
+{
+    uint8_t container_index = (uint8_t)Luos_GetContainerIndex(container);
+    uint16_t time_ms        = Luos_PeriodToMs(sub->min_period);
+    uint16_t max_time_ms    = Luos_PeriodToMs(sub->max_period);
+    // Remove this subscriber from its previous timed update
+    for (uint16_t i = 0; i < timed_update_number; i++)
+    {
+        timed_update_t *update = &timed_update_heap[i];
+        if (update->container_index != container_index)
+        {
+            continue;
+        }
+        for (uint8_t j = 0; j < update->target_nb; j++)
+        {
+            if (update->target[j] == target)
             {
-                if ((LuosHAL_GetSystick() - container_table[i].auto_refresh.last_update) >= container_table[i].auto_refresh.time_ms)
+                update->target[j] = update->target[--update->target_nb];
+                break;
+            }
+        }
+        if (update->target_nb == 0)
+        {
+            Luos_RemoveUpdate(i);
+            break;
+        }
+    }
+    if (time_ms == 0)
+    {
+        return;
+    }
+    // Share an existing timed update with the same period
+    for (uint16_t i = 0; i < timed_update_number; i++)
+    {
+        timed_update_t *update = &timed_update_heap[i];
+        if ((update->container_index == container_index) && (update->time_ms == time_ms) && (update->target_nb < MAX_TIMED_UPDATE_TARGET)
+            && (update->on_change == on_change) && (update->max_time_ms == max_time_ms) && (update->deadband == sub->deadband))
+        {
+            update->target[update->target_nb++] = target;
+            return;
+        }
+    }
+    // Create a new timed update
+    LUOS_ASSERT(timed_update_number < MAX_TIMED_UPDATE);
+    timed_update_t *update  = &timed_update_heap[timed_update_number];
+    update->next_update     = LuosHAL_GetSystick() + time_ms;
+    update->time_ms         = time_ms;
+    update->target[0]       = target;
+    update->target_nb       = 1;
+    update->container_index = container_index;
+    update->on_change       = on_change;
+    update->max_time_ms     = max_time_ms;
+    update->deadband        = sub->deadband;
+    update->value_size      = 0;
+    Luos_SiftUpdate(timed_update_number++);
+}
+/******************************************************************************
+ * @brief Convert a timed update period into ms
+ * @param period to convert
+ * @return rounded period in ms, 0 for negative periods and clamped to MAX_UPDATE_PERIOD
+ ******************************************************************************/
+static uint16_t Luos_PeriodToMs(time_luos_t period)
+{
+    // Written to also catch NaN periods
+    if (!(period > 0))
+    {
+        return 0;
+    }
+    if (period >= MAX_UPDATE_PERIOD)
+    {
+        return UINT16_MAX;
+    }
+#ifdef OD_FIXED_POINT
+    // Periods over 32.767 s don't fit Q16.16 once in ms, round them using 64 bits
+    return (uint16_t)((((int64_t)period * 1000) + (1 << (OD_FIXED_FRAC_BITS - 1))) >> OD_FIXED_FRAC_BITS);
+#else
+    return (uint16_t)((period * 1000.0f) + 0.5f);
+#endif
+}
+/******************************************************************************
+ * @brief Move a timed update to its place in the heap
+ * @param index of the timed update to move
+ * @return None
+ ******************************************************************************/
+static void Luos_SiftUpdate(uint16_t index)
+{
+    timed_update_t moved = timed_update_heap[index];
+    // Go up while the parent is later
+    while (index > 0)
+    {
+        uint16_t parent = (index - 1) / 2;
+        if ((int32_t)(timed_update_heap[parent].next_update - moved.next_update) <= 0)
+        {
+            break;
+        }
+        timed_update_heap[index] = timed_update_heap[parent];
+        index                    = parent;
+    }
+    // Go down while a child is sooner
+    while ((2 * index + 1) < timed_update_number)
+    {
+        uint16_t child = 2 * index + 1;
+        if (((child + 1) < timed_update_number) && ((int32_t)(timed_update_heap[child + 1].next_update - timed_update_heap[child].next_update) < 0))
+        {
+            child++;
+        }
+        if ((int32_t)(moved.next_update - timed_update_heap[child].next_update) <= 0)
+        {
+            break;
+        }
+        timed_update_heap[index] = timed_update_heap[child];
+        index                    = child;
+    }
+    timed_update_heap[index] = moved;
+}
+/******************************************************************************
+ * @brief Remove a timed update from the heap
+ * @param index of the timed update to remove
+ * @return None
+ ******************************************************************************/
+static void Luos_RemoveUpdate(uint16_t index)
+{
+    timed_update_number--;
+    if (index < timed_update_number)
+    {
+        timed_update_heap[index] = timed_update_heap[timed_update_number];
+        Luos_SiftUpdate(index);
+    }
+}
+/******************************************************************************
+ * @brief Check if a timed update value need to be published
+ * Values are compared using their object dictionary type, unknown types are published on any change.
+ * The payload size gives the OD values encoding : 2, 3 and 4 bytes are a single float16, int24 or float32
+ * value, bigger payloads are several values using the OD_ENCODING of this node.
+ * @param update timed update publishing the value
+ * @param msg containing the value
+ * @return SUCCEED if the value have to be published
+ ******************************************************************************/
+static error_return_t Luos_UpdateValueChanged(timed_update_t *update, msg_t *msg)
+{
+    uint32_t date          = LuosHAL_GetSystick();
+    error_return_t changed = FAILED;
+    uint8_t element_size   = 0;
+    if (update->on_change == false)
+    {
+        return SUCCEED;
+    }
+    if ((update->value_size == 0) || (update->value_cmd != msg->header.cmd) || (update->value_size != msg->header.size)
+        || ((update->max_time_ms != 0) && ((date - update->last_publish) >= update->max_time_ms)))
+    {
+        changed = SUCCEED;
+    }
+    else
+    {
+        switch (msg->header.cmd)
+        {
+            case RATIO:
+            case ILLUMINANCE:
+            case VOLTAGE:
+            case CURRENT:
+            case POWER:
+            case TEMPERATURE:
+            case TIME:
+            case FORCE:
+            case MOMENT:
+            case ANGULAR_POSITION:
+            case ANGULAR_SPEED:
+            case LINEAR_POSITION:
+            case LINEAR_SPEED:
+            case LINEAR_ACCEL:
+            case GRAVITY_VECTOR:
+                // OD values, a single value of any encoding or several values encoded with OD_ENCODING
+                element_size = sizeof(float);
+                if ((msg->header.size == OD_FLOAT16) || (msg->header.size == OD_INT24))
+                {
+                    element_size = (uint8_t)msg->header.size;
+                }
+                else if (msg->header.size > sizeof(float))
                 {
-                    // This container need to send an update
-                    // Create a fake message for it from the container asking for update
-                    msg_t updt_msg;
-                    updt_msg.header.target      = container_table[i].ll_container->id;
-                    updt_msg.header.source      = container_table[i].auto_refresh.target;
-                    updt_msg.header.target_mode = IDACK;
-                    updt_msg.header.cmd         = ASK_PUB_CMD;
-                    updt_msg.header.size        = 0;
-                    if ((container_table[i].cont_cb != 0))
+                    element_size = OD_ENCODING;
+                }
+                for (uint8_t i = 0; (i + element_size) <= msg->header.size; i += element_size)
+                {
+                    od_value_t previous = 0;
+                    od_value_t current  = 0;
+                    OD_ValueFromData(&previous, &update->value[i], element_size, OD_GetFracBits(msg->header.cmd));
+                    OD_ValueFromData(&current, &msg->data[i], element_size, OD_GetFracBits(msg->header.cmd));
+                    if (OD_ValueMoved(previous, current, update->deadband))
                     {
-                        container_table[i].cont_cb(&container_table[i], &updt_msg);
+                        changed = SUCCEED;
                     }
-                    else
+                }
+                break;
+            case PEDOMETER:
+            case ACCEL_3D:
+            case GYRO_3D:
+            case QUATERNION:
+            case COMPASS_3D:
+            case EULER_3D:
+            case HEADING:
+                // long values
+                for (uint8_t i = 0; (i + sizeof(int32_t)) <= msg->header.size; i += sizeof(int32_t))
+                {
+                    int32_t previous, current;
+                    memcpy(&previous, &update->value[i], sizeof(int32_t));
+                    memcpy(&current, &msg->data[i], sizeof(int32_t));
+                    // Integer distances only move further than the integer part of the deadband
+                    int64_t distance = (int64_t)current - (int64_t)previous;
+                    if ((distance > OD_TO_INT(update->deadband)) || (-distance > OD_TO_INT(update->deadband)))
                     {
-                        //store container and msg pointer
-                        // todo this can't work for now because this message is not permanent.
-                        //mngr_set(&container_table[i], &updt_msg);
+                        changed = SUCCEED;
                     }
-                    container_table[i].auto_refresh.last_update = LuosHAL_GetSystick();
                 }
+                element_size = sizeof(int32_t);
+                break;
+            default:
+                break;
+        }
+        if ((element_size == 0) || (msg->header.size % element_size))
+        {
+            // No deadband for this type, publish it on any change
+            if (memcmp(update->value, msg->data, msg->header.size) != 0)
+            {
+                changed = SUCCEED;
             }
         }
     }
+    if (changed == SUCCEED)
+    {
+        // Save this value as the last published one
+        if (msg->header.size <= TIMED_UPDATE_VALUE_SIZE)
+        {
+            memcpy(update->value, msg->data, msg->header.size);
+            update->value_size = (uint8_t)msg->header.size;
+        }
+        else
+        {
+            // This value is too big to be saved, it will always be published
+            update->value_size = 0;
+        }
+        update->value_cmd    = msg->header.cmd;
+        update->last_publish = date;
+    }
+    return changed;
 }
 /******************************************************************************
  * @brief clear list of container
@@ -457,7 +933,11 @@ static void Luos_AutoUpdateManager(void)
  ******************************************************************************/
 void Luos_ContainersClear(void)
 {
-    container_number = 0;
+    container_number    = 0;
+    timed_update_number = 0;
+    timer_number        = 0;
+    task_number         = 0;
+    request_number      = 0;
     Robus_ContainersClear();
 }
 /******************************************************************************
@@ -473,9 +953,16 @@ container_t *Luos_CreateContainer(CONT_CB cont_cb, uint8_t type, const char *ali
     uint8_t i               = 0;
     container_t *container  = &container_table[container_number];
     container->ll_container = Robus_ContainerCreate(type);
+    // Containers and ll_containers have to be at the same index to directly find each other
+    LUOS_ASSERT(container->ll_container == (container_table[0].ll_container + container_number));
 
     // Link the container to his callback
-    container->cont_cb = cont_cb;
+    container->cont_cb       = cont_cb;
+    container->dispatch      = 0;
+    container->batch_cb      = 0;
+    container->batch_held_nb = 0;
+    // By default a container accept all commands
+    memset(container->cmd_filter, 0xFF, sizeof(container->cmd_filter));
     // Save default alias
     for (i = 0; i < MAX_ALIAS_SIZE - 1; i++)
     {
@@ -513,6 +1000,122 @@ container_t *Luos_CreateContainer(CONT_CB cont_cb, uint8_t type, const char *ali
     container_number++;
     return container;
 }
+/******************************************************************************
+ * @brief Register a command dispatch table to a container
+ * Messages are given to the handler of their command instead of the container callback.
+ * Replies of the container requests and messages awaited by its tasks are received even if they are not in the table.
+ * @param container to register the table to
+ * @param dispatch table created with LUOS_DISPATCH_TABLE
+ * @return None
+ ******************************************************************************/
+void Luos_SetDispatchTable(container_t *container, const luos_dispatch_table_t *dispatch)
+{
+    // Check that entries are sorted and don't overlap
+    for (uint16_t i = 0; i < dispatch->nb; i++)
+    {
+        LUOS_ASSERT(dispatch->entries[i].first_cmd <= dispatch->entries[i].last_cmd);
+        LUOS_ASSERT(dispatch->entries[i].handler != 0);
+        if (i > 0)
+        {
+            LUOS_ASSERT(dispatch->entries[i - 1].last_cmd < dispatch->entries[i].first_cmd);
+        }
+    }
+    container->dispatch = dispatch;
+    // Only accept commands of the table
+    Luos_AcceptCmd(container, 0, 0xFF, false);
+    for (uint16_t i = 0; i < dispatch->nb; i++)
+    {
+        Luos_AcceptCmd(container, dispatch->entries[i].first_cmd, dispatch->entries[i].last_cmd, true);
+    }
+}
+/******************************************************************************
+ * @brief Register a batch callback to a container
+ * The callback receive all the pending messages of the container in arrival order
+ * and return the number of messages it consumed, others will be given again on the next loop.
+ * Messages left pending don't keep the node awake (see Luos_NextEventTick), they are given
+ * again with the next message or event. Use a timer to bound their latency.
+ * @param container to register the callback to
+ * @param batch_cb callback to call, 0 to go back to one message by call
+ * @return None
+ ******************************************************************************/
+void Luos_SetBatchCallback(container_t *container, BATCH_CB batch_cb)
+{
+    container->batch_cb      = batch_cb;
+    container->batch_held_nb = 0;
+}
+/******************************************************************************
+ * @brief Select commands a container accept
+ * Messages with commands accepted by none of the node containers are dropped at reception.
+ * Luos commands, replies of the container requests and messages awaited by its tasks are always accepted.
+ * @param container to configure
+ * @param first_cmd first command of the range
+ * @param last_cmd last command of the range
+ * @param accept true to accept the range, false to drop it
+ * @return None
+ ******************************************************************************/
+void Luos_AcceptCmd(container_t *container, uint8_t first_cmd, uint8_t last_cmd, uint8_t accept)
+{
+    LUOS_ASSERT(first_cmd <= last_cmd);
+    for (uint16_t cmd = first_cmd; cmd <= last_cmd; cmd++)
+    {
+        if (accept)
+        {
+            container->cmd_filter[cmd >> 3] |= (uint8_t)(1u << (cmd & 0x07));
+        }
+        else
+        {
+            container->cmd_filter[cmd >> 3] &= (uint8_t)~(1u << (cmd & 0x07));
+        }
+    }
+    Luos_UpdateCmdFilter(container);
+}
+/******************************************************************************
+ * @brief Give to Robus the commands a container have to receive
+ * Commands accepted by the container are completed with Luos commands,
+ * replies of its pending requests and messages awaited by its tasks.
+ * @param container to update
+ * @return None
+ ******************************************************************************/
+static void Luos_UpdateCmdFilter(container_t *container)
+{
+    uint8_t filter[CMD_FILTER_SIZE];
+    uint16_t cmd = 0;
+    memcpy(filter, container->cmd_filter, CMD_FILTER_SIZE);
+    for (cmd = 0; cmd < ASK_PUB_CMD; cmd++)
+    {
+        filter[cmd >> 3] |= (uint8_t)(1u << (cmd & 0x07));
+    }
+    for (cmd = RTB_SHARE; cmd <= RTB_EPOCH; cmd++)
+    {
+        filter[cmd >> 3] |= (uint8_t)(1u << (cmd & 0x07));
+    }
+    for (uint16_t i = 0; i < request_number; i++)
+    {
+        if (request_table[i].container == container)
+        {
+            if (request_table[i].cmd == ASK_PUB_CMD)
+            {
+                // Any command can reply to an ASK_PUB_CMD
+                memset(filter, 0xFF, CMD_FILTER_SIZE);
+                break;
+            }
+            filter[request_table[i].cmd >> 3] |= (uint8_t)(1u << (request_table[i].cmd & 0x07));
+        }
+    }
+    for (uint16_t i = 0; i < task_number; i++)
+    {
+        luos_task_t *task = task_table[i];
+        if ((task->container == container) && ((task->wait == TASK_WAIT_MSG) || (task->wait == TASK_WAIT_MSG_OR_TIME)))
+        {
+            filter[task->wait_cmd >> 3] |= (uint8_t)(1u << (task->wait_cmd & 0x07));
+        }
+    }
+    // Only touch the node filter if something changed
+    if (memcmp(filter, container->ll_container->cmd_filter, CMD_FILTER_SIZE) != 0)
+    {
+        Robus_SetCmdFilter(container->ll_container, filter);
+    }
+}
 /******************************************************************************
  * @brief Send msg through network
  * @param Container who send
@@ -526,6 +1129,25 @@ error_return_t Luos_SendMsg(container_t *container, msg_t *msg)
         // There is no container specified here, take the first one
         container = &container_table[0];
     }
+    if ((publishing_update != NULL) && (msg->header.target == publishing_update->target[0]) && (msg->header.target_mode <= IDACK))
+    {
+        if (Luos_UpdateValueChanged(publishing_update, msg) == FAILED)
+        {
+            // Subscribers already have this value
+            return SUCCEED;
+        }
+        // This is the reply to a timed update, send it to all the subscribers
+        for (uint8_t i = 1; i < publishing_update->target_nb; i++)
+        {
+            msg->header.target = publishing_update->target[i];
+            if (Robus_SendMsg(container->ll_container, msg) == FAILED)
+            {
+                msg->header.target = publishing_update->target[0];
+                return FAILED;
+            }
+        }
+        msg->header.target = publishing_update->target[0];
+    }
     if (Robus_SendMsg(container->ll_container, msg) == FAILED)
     {
         return FAILED;
@@ -725,22 +1347,82 @@ error_return_t Luos_ReceiveData(container_t *container, msg_t *msg, void *bin_da
     return FAILED;
 }
 /******************************************************************************
- * @brief Send datas of a streaming channel
+ * @brief Send datas of a streaming channel using its codec
+ * Encoded messages carry a variable number of samples, each one is sent as a
+ * complete message.
  * @param Container who send
  * @param Message to send
  * @param streaming channel pointer
+ * @param frame_size size of the frame header preceding the samples
+ * @param data_size number of samples to send
  * @return None
  ******************************************************************************/
-void Luos_SendStreaming(container_t *container, msg_t *msg, streaming_channel_t *stream)
+static void Luos_SendEncodedStreaming(container_t *container, msg_t *msg, streaming_channel_t *stream, uint16_t frame_size, uint16_t data_size)
 {
-    // Compute number of message needed to send available datas on ring buffer
-    int msg_number              = 1;
-    int data_size               = Stream_GetAvailableSampleNB(stream);
-    const int max_data_msg_size = (MAX_DATA_MSG_SIZE / stream->data_size);
-    if (data_size > max_data_msg_size)
+    do
     {
-        msg_number = (data_size / max_data_msg_size);
-        msg_number += ((msg_number * max_data_msg_size) < data_size);
+        uint16_t sample_nb = data_size;
+        if (stream->timing != NULL)
+        {
+            Stream_MakeFrame(stream, (stream_frame_t *)msg->data);
+        }
+        msg->header.size = frame_size + Stream_EncodeSample(stream, &msg->data[frame_size], MAX_DATA_MSG_SIZE - frame_size, &sample_nb);
+        data_size -= sample_nb;
+        if (stream->credit != NULL)
+        {
+            stream->credit->count += sample_nb;
+        }
+
+        // Send message
+        while (Luos_SendMsg(container, msg) == FAILED)
+        {
+            Luos_Loop();
+        }
+    } while (data_size > 0);
+}
+/******************************************************************************
+ * @brief Send datas of a streaming channel
+ * @param Container who send
+ * @param Message to send
+ * @param streaming channel pointer
+ * @return None
+ ******************************************************************************/
+void Luos_SendStreaming(container_t *container, msg_t *msg, streaming_channel_t *stream)
+{
+    if (container == 0)
+    {
+        // There is no container specified here, take the first one
+        container = &container_table[0];
+    }
+    // Flow controlled channels only send the samples granted by the receiver
+    uint16_t data_size = Stream_GetAvailableSampleNB(stream);
+    uint16_t credit    = Stream_GetCredit(stream);
+    if (data_size > credit)
+    {
+        data_size = credit;
+    }
+    if ((stream->credit != NULL) && (data_size == 0))
+    {
+        return;
+    }
+    // Timestamped channels send a frame header before the samples of each message
+    uint16_t frame_size = 0;
+    if (stream->timing != NULL)
+    {
+        frame_size = sizeof(stream_frame_t);
+    }
+    if (stream->codec != 0)
+    {
+        Luos_SendEncodedStreaming(container, msg, stream, frame_size, data_size);
+        return;
+    }
+    // Compute number of message needed to send available datas on ring buffer
+    uint16_t msg_number              = 1;
+    const uint16_t max_data_msg_size = ((MAX_DATA_MSG_SIZE - frame_size) / stream->data_size);
+    if (data_size > max_data_msg_size)
+    {
+        msg_number = (data_size / max_data_msg_size);
+        msg_number += ((msg_number * max_data_msg_size) < data_size);
     }
 
     // Send messages one by one
@@ -757,14 +1439,37 @@ void Luos_SendStreaming(container_t *container, msg_t *msg, streaming_channel_t
             chunk_size = data_size;
         }
 
-        // Copy data into message
-        Stream_GetSample(stream, msg->data, chunk_size);
+        // Send the frame header from the message and the samples directly from the ring buffer
+        stream_span_t stream_spans[2];
+        data_span_t spans[MAX_DATA_SPAN];
+        if (stream->timing != NULL)
+        {
+            Stream_MakeFrame(stream, (stream_frame_t *)msg->data);
+        }
+        Stream_PeekSpans(stream, stream_spans);
+        if (stream_spans[0].size > chunk_size)
+        {
+            stream_spans[0].size = chunk_size;
+        }
+        spans[0].data    = msg->data;
+        spans[0].size    = frame_size;
+        spans[1].data    = stream_spans[0].data;
+        spans[1].size    = stream_spans[0].size * stream->data_size;
+        spans[2].data    = stream_spans[1].data;
+        spans[2].size    = (chunk_size - stream_spans[0].size) * stream->data_size;
+        msg->header.size = (data_size * stream->data_size) + ((msg_number - chunk) * frame_size);
 
         // Send message
-        while (Luos_SendMsg(container, msg) == FAILED)
+        while (Robus_SendMsgSpans(container->ll_container, msg, spans, MAX_DATA_SPAN) == FAILED)
         {
             Luos_Loop();
         }
+        // Samples are now copied into the transmit buffer
+        Stream_CommitRead(stream, chunk_size);
+        if (stream->credit != NULL)
+        {
+            stream->credit->count += chunk_size;
+        }
 
         // check end of data
         if (data_size > max_data_msg_size)
@@ -794,7 +1499,34 @@ error_return_t Luos_ReceiveStreaming(container_t *container, msg_t *msg, streami
         chunk_size = msg->header.size;
 
     // Copy data into buffer
-    Stream_PutSample(stream, msg->data, (chunk_size / stream->data_size));
+    uint16_t sample_nb = 0;
+    if (stream->codec != 0)
+    {
+        // Encoded messages are complete, samples may follow a frame header
+        uint16_t frame_size = (stream->timing != NULL) ? sizeof(stream_frame_t) : 0;
+        if (chunk_size >= frame_size)
+        {
+            sample_nb = Stream_DecodeSample(stream, (frame_size != 0) ? (stream_frame_t *)msg->data : NULL, &msg->data[frame_size], chunk_size - frame_size);
+        }
+    }
+    else if (stream->timing != NULL)
+    {
+        // Samples follow a frame header
+        if (chunk_size >= sizeof(stream_frame_t))
+        {
+            sample_nb = (chunk_size - sizeof(stream_frame_t)) / stream->data_size;
+            Stream_PutFrame(stream, (stream_frame_t *)msg->data, &msg->data[sizeof(stream_frame_t)], sample_nb);
+        }
+    }
+    else
+    {
+        sample_nb = chunk_size / stream->data_size;
+        Stream_PutSample(stream, msg->data, sample_nb);
+    }
+    if (stream->credit != NULL)
+    {
+        stream->credit->count += sample_nb;
+    }
 
     // Check end of data
     if ((msg->header.size <= MAX_DATA_MSG_SIZE))
@@ -804,6 +1536,43 @@ error_return_t Luos_ReceiveStreaming(container_t *container, msg_t *msg, streami
     }
     return FAILED;
 }
+/******************************************************************************
+ * @brief Grant credits to the sender of a flow controlled streaming channel
+ * This have to be called periodically by the receiver, at least each time it
+ * consumed a part of the channel.
+ * @param Container who receive the streaming
+ * @param target sending the streaming
+ * @param streaming channel pointer
+ * @return error
+ ******************************************************************************/
+error_return_t Luos_SendStreamingCredit(container_t *container, uint16_t target, streaming_channel_t *stream)
+{
+    msg_t msg;
+    uint32_t limit         = Stream_ComputeGrant(stream);
+    msg.header.target      = target;
+    msg.header.target_mode = ID;
+    msg.header.cmd         = STREAM_CREDIT;
+    msg.header.size        = sizeof(uint32_t);
+    memcpy(msg.data, &limit, sizeof(uint32_t));
+    return Luos_SendMsg(container, &msg);
+}
+/******************************************************************************
+ * @brief Receive credits granted to a flow controlled streaming channel
+ * @param Message received
+ * @param streaming channel pointer
+ * @return error
+ ******************************************************************************/
+error_return_t Luos_ReceiveStreamingCredit(msg_t *msg, streaming_channel_t *stream)
+{
+    uint32_t limit;
+    if ((msg->header.cmd != STREAM_CREDIT) || (msg->header.size != sizeof(uint32_t)))
+    {
+        return FAILED;
+    }
+    memcpy(&limit, msg->data, sizeof(uint32_t));
+    Stream_GrantCredit(stream, limit);
+    return SUCCEED;
+}
 /******************************************************************************
  * @brief store alias name container in flash
  * @param container to store
@@ -906,6 +1675,476 @@ uint32_t Luos_GetSystick(void)
 {
     return LuosHAL_GetSystick();
 }
+/******************************************************************************
+ * @brief Get the time spent with nothing to do
+ * Time between two Luos_Loop where no message and no timer were managed.
+ * @param None
+ * @return idle time in ms since Luos_Init
+ ******************************************************************************/
+uint32_t Luos_GetIdleTime(void)
+{
+    return idle_time_ms;
+}
+/******************************************************************************
+ * @brief Get the date of the next thing Luos_Loop will have to do
+ * The node can sleep until this date or until node_wakeup is called.
+ * @param None
+ * @return systick date of the next event, now if Luos_Loop have to run
+ ******************************************************************************/
+uint32_t Luos_NextEventTick(void)
+{
+    uint32_t date     = LuosHAL_GetSystick();
+    uint32_t next     = date + MAX_SLEEP_MS;
+    uint16_t batch_nb = 0;
+    if (MsgAlloc_TaskPending() == SUCCEED)
+    {
+        // There is messages to interpret
+        return date;
+    }
+    // Messages left pending by batch callbacks wait for the next event, others have to be managed
+    for (uint16_t i = 0; i < container_number; i++)
+    {
+        if (container_table[i].batch_cb == 0)
+        {
+            continue;
+        }
+        uint16_t nb                  = 0;
+        ll_container_t *ll_container = 0;
+        for (uint16_t task = 0; MsgAlloc_LookAtLuosTask(task, &ll_container) == SUCCEED; task++)
+        {
+            if (ll_container == container_table[i].ll_container)
+            {
+                nb++;
+            }
+        }
+        if (nb > container_table[i].batch_held_nb)
+        {
+            // This batch container received new messages
+            return date;
+        }
+        batch_nb += nb;
+    }
+    if (MsgAlloc_LuosTasksNbr() > batch_nb)
+    {
+        // There is messages to manage
+        return date;
+    }
+    if ((timer_number > 0) && ((int32_t)(timer_heap[0]->deadline - next) < 0))
+    {
+        next = timer_heap[0]->deadline;
+    }
+    for (uint16_t i = 0; i < task_number; i++)
+    {
+        if (task_table[i]->wait == TASK_WAIT_CONDITION)
+        {
+            // This task have to be polled
+            return date;
+        }
+        if ((task_table[i]->wait != TASK_WAIT_MSG) && ((int32_t)(task_table[i]->deadline - next) < 0))
+        {
+            next = task_table[i]->deadline;
+        }
+    }
+    for (uint16_t i = 0; i < request_number; i++)
+    {
+        if ((int32_t)(request_table[i].deadline - next) < 0)
+        {
+            next = request_table[i].deadline;
+        }
+    }
+    if ((timed_update_number > 0) && ((int32_t)(timed_update_heap[0].next_update - next) < 0))
+    {
+        next = timed_update_heap[0].next_update;
+    }
+    if ((int32_t)(next - date) < 0)
+    {
+        // We are late
+        return date;
+    }
+    return next;
+}
+/******************************************************************************
+ * @brief Start or restart a timer calling back from Luos_Loop
+ * @param container owning the timer
+ * @param timer to start, this memory must stay available while the timer is running
+ * @param delay_ms time before the first call
+ * @param period_ms time between calls, 0 for a one shot timer
+ * @param callback function to call
+ * @return None
+ ******************************************************************************/
+void Luos_TimerStart(container_t *container, luos_timer_t *timer, uint32_t delay_ms, uint32_t period_ms, TIMER_CB callback)
+{
+    LUOS_ASSERT(callback != 0);
+    if (Luos_TimerIsRunning(timer) == FAILED)
+    {
+        // Add it at the end of the heap
+        LUOS_ASSERT(timer_number < MAX_LUOS_TIMER);
+        timer->heap_index        = timer_number;
+        timer_heap[timer_number] = timer;
+        timer_number++;
+    }
+    timer->container = container;
+    timer->callback  = callback;
+    timer->period_ms = period_ms;
+    timer->deadline  = LuosHAL_GetSystick() + delay_ms;
+    Luos_SiftTimer(timer->heap_index);
+}
+/******************************************************************************
+ * @brief Stop a timer
+ * @param timer to stop
+ * @return None
+ ******************************************************************************/
+void Luos_TimerStop(luos_timer_t *timer)
+{
+    if (Luos_TimerIsRunning(timer) == FAILED)
+    {
+        return;
+    }
+    uint16_t index = timer->heap_index;
+    timer_number--;
+    if (index < timer_number)
+    {
+        timer_heap[index]             = timer_heap[timer_number];
+        timer_heap[index]->heap_index = index;
+        Luos_SiftTimer(index);
+    }
+}
+/******************************************************************************
+ * @brief Check if a timer is running
+ * @param timer to check
+ * @return SUCCEED if the timer is running
+ ******************************************************************************/
+error_return_t Luos_TimerIsRunning(luos_timer_t *timer)
+{
+    if ((timer->heap_index < timer_number) && (timer_heap[timer->heap_index] == timer))
+    {
+        return SUCCEED;
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief Start a cooperative task
+ * The task body is called from Luos_Loop until it ends (see LUOS_TASK_BEGIN).
+ * @param container running the task
+ * @param task to start, this memory must stay available while the task is running
+ * @param function task body
+ * @return None
+ ******************************************************************************/
+void Luos_TaskStart(container_t *container, luos_task_t *task, TASK_CB function)
+{
+    LUOS_ASSERT(function != 0);
+    Luos_TaskStop(task);
+    LUOS_ASSERT(task_number < MAX_LUOS_TASK);
+    task->line                = 0;
+    task->wait                = TASK_WAIT_CONDITION;
+    task->msg                 = NULL;
+    task->container           = container;
+    task->function            = function;
+    task_table[task_number++] = task;
+}
+/******************************************************************************
+ * @brief Stop a cooperative task
+ * @param task to stop
+ * @return None
+ ******************************************************************************/
+void Luos_TaskStop(luos_task_t *task)
+{
+    for (uint16_t i = 0; i < task_number; i++)
+    {
+        if (task_table[i] == task)
+        {
+            // Keep tasks order
+            task_number--;
+            for (uint16_t j = i; j < task_number; j++)
+            {
+                task_table[j] = task_table[j + 1];
+            }
+            Luos_UpdateCmdFilter(task->container);
+            return;
+        }
+    }
+}
+/******************************************************************************
+ * @brief Make a task wait for a message (see LUOS_TASK_AWAIT_MSG)
+ * @param task waiting
+ * @param source ID of the container sending the message, 0 for any
+ * @param cmd of the message
+ * @param timeout_ms time to wait the message, 0 to wait forever
+ * @return None
+ ******************************************************************************/
+void Luos_TaskWaitMsg(luos_task_t *task, uint16_t source, uint8_t cmd, uint32_t timeout_ms)
+{
+    task->wait_source = source;
+    task->wait_cmd    = cmd;
+    task->msg         = NULL;
+    task->deadline    = LuosHAL_GetSystick() + timeout_ms;
+    task->wait        = (timeout_ms == 0) ? TASK_WAIT_MSG : TASK_WAIT_MSG_OR_TIME;
+    // The awaited command have to be received even if the container don't accept it
+    Luos_UpdateCmdFilter(task->container);
+}
+/******************************************************************************
+ * @brief Make a task wait for some time (see LUOS_TASK_AWAIT_TIME)
+ * @param task waiting
+ * @param delay_ms time to wait
+ * @return None
+ ******************************************************************************/
+void Luos_TaskWaitTime(luos_task_t *task, uint32_t delay_ms)
+{
+    task->deadline = LuosHAL_GetSystick() + delay_ms;
+    task->wait     = TASK_WAIT_TIME;
+}
+/******************************************************************************
+ * @brief Find a task waiting for a message
+ * @param container receiving the message
+ * @param source of the message
+ * @param cmd of the message
+ * @return task waiting for this message, NULL if there is none
+ ******************************************************************************/
+static luos_task_t *Luos_TaskWaitingFor(container_t *container, uint16_t source, uint8_t cmd)
+{
+    for (uint16_t i = 0; i < task_number; i++)
+    {
+        luos_task_t *task = task_table[i];
+        if ((task->container == container) && ((task->wait == TASK_WAIT_MSG) || (task->wait == TASK_WAIT_MSG_OR_TIME))
+            && (task->wait_cmd == cmd) && ((task->wait_source == 0) || (task->wait_source == source)))
+        {
+            return task;
+        }
+    }
+    return NULL;
+}
+/******************************************************************************
+ * @brief Resume a task
+ * @param task to resume
+ * @return None
+ ******************************************************************************/
+static void Luos_TaskRun(luos_task_t *task)
+{
+    task->wait = TASK_WAIT_CONDITION;
+    if (task->function(task->container, task) == LUOS_TASK_ENDED)
+    {
+        Luos_TaskStop(task);
+    }
+    else
+    {
+        // Stop accepting the previously awaited command if the task don't await it anymore
+        Luos_UpdateCmdFilter(task->container);
+    }
+}
+/******************************************************************************
+ * @brief Resume all tasks ready to run
+ * Tasks waiting for a condition are polled, others are resumed on timeout.
+ * @param None
+ * @return true if a task have been resumed on an event
+ ******************************************************************************/
+static uint8_t Luos_TaskManager(void)
+{
+    uint8_t resumed = false;
+    uint32_t date   = LuosHAL_GetSystick();
+    uint16_t i      = 0;
+    while (i < task_number)
+    {
+        luos_task_t *task = task_table[i];
+        if (task->wait == TASK_WAIT_MSG)
+        {
+            i++;
+            continue;
+        }
+        if (task->wait != TASK_WAIT_CONDITION)
+        {
+            if ((int32_t)(date - task->deadline) < 0)
+            {
+                i++;
+                continue;
+            }
+            // Timeout, a message waiting task get a NULL message
+            task->msg = NULL;
+            resumed   = true;
+        }
+        Luos_TaskRun(task);
+        if ((i < task_number) && (task_table[i] == task))
+        {
+            i++;
+        }
+    }
+    return resumed;
+}
+/******************************************************************************
+ * @brief Send a request to a container and get its reply without blocking
+ * The reply is the first message coming from the target with the same command,
+ * or any message coming from the target for an ASK_PUB_CMD request.
+ * @param container making the request
+ * @param target ID of the container to ask
+ * @param cmd of the request
+ * @param payload data of the request
+ * @param size of the payload
+ * @param timeout_ms time to wait the reply
+ * @param callback function receiving the reply from Luos_Loop, with a NULL reply on timeout
+ * @return FAILED if too many requests are waiting or if the request can't be sent
+ ******************************************************************************/
+error_return_t Luos_Request(container_t *container, uint16_t target, uint8_t cmd, void *payload, uint16_t size, uint32_t timeout_ms, REQUEST_CB callback)
+{
+    msg_t msg;
+    LUOS_ASSERT((callback != 0) && (size <= MAX_DATA_MSG_SIZE));
+    if (request_number >= MAX_LUOS_REQUEST)
+    {
+        return FAILED;
+    }
+    msg.header.target      = target;
+    msg.header.target_mode = IDACK;
+    msg.header.cmd         = cmd;
+    msg.header.size        = size;
+    memcpy(msg.data, payload, size);
+    // Register the request before sending it to accept the reply as soon as it comes
+    luos_request_t *request = &request_table[request_number++];
+    request->target         = target;
+    request->cmd            = cmd;
+    request->deadline       = LuosHAL_GetSystick() + timeout_ms;
+    request->container      = container;
+    request->callback       = callback;
+    Luos_UpdateCmdFilter(container);
+    if (Luos_SendMsg(container, &msg) == FAILED)
+    {
+        request_number--;
+        Luos_UpdateCmdFilter(container);
+        return FAILED;
+    }
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief Find the oldest request waiting for a message
+ * @param container receiving the message
+ * @param source of the message
+ * @param cmd of the message
+ * @return index of the request, request_number if there is none
+ ******************************************************************************/
+static uint16_t Luos_RequestWaitingFor(container_t *container, uint16_t source, uint8_t cmd)
+{
+    uint16_t i = 0;
+    for (i = 0; i < request_number; i++)
+    {
+        if ((request_table[i].container == container) && (request_table[i].target == source)
+            && ((request_table[i].cmd == cmd) || (request_table[i].cmd == ASK_PUB_CMD)))
+        {
+            break;
+        }
+    }
+    return i;
+}
+/******************************************************************************
+ * @brief Remove a request and give its reply to its callback
+ * @param index of the request
+ * @param reply_msg received, NULL on timeout
+ * @return None
+ ******************************************************************************/
+static void Luos_RequestEnd(uint16_t index, msg_t *reply_msg)
+{
+    // The callback can make new requests, remove this one first
+    luos_request_t request = request_table[index];
+    request_number--;
+    for (uint16_t i = index; i < request_number; i++)
+    {
+        request_table[i] = request_table[i + 1];
+    }
+    Luos_UpdateCmdFilter(request.container);
+    request.callback(request.container, &request, reply_msg);
+}
+/******************************************************************************
+ * @brief Time out requests without reply
+ * @param None
+ * @return true if a request timed out
+ ******************************************************************************/
+static uint8_t Luos_RequestManager(void)
+{
+    uint8_t timeout = false;
+    uint32_t date   = LuosHAL_GetSystick();
+    uint16_t i      = 0;
+    while (i < request_number)
+    {
+        if ((int32_t)(date - request_table[i].deadline) >= 0)
+        {
+            Luos_RequestEnd(i, NULL);
+            timeout = true;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return timeout;
+}
+/******************************************************************************
+ * @brief Call back all expired timers
+ * Timers are sorted by deadline, only expired ones are looked at.
+ * @param None
+ * @return true if at least a timer have been called
+ ******************************************************************************/
+static uint8_t Luos_TimerManager(void)
+{
+    uint8_t called = false;
+    uint32_t date  = LuosHAL_GetSystick();
+    while ((timer_number > 0) && ((int32_t)(date - timer_heap[0]->deadline) >= 0))
+    {
+        luos_timer_t *timer = timer_heap[0];
+        if (timer->period_ms)
+        {
+            // Schedule the next call without drifting, unless we are late of more than a period
+            timer->deadline += timer->period_ms;
+            if ((int32_t)(date - timer->deadline) >= 0)
+            {
+                timer->deadline = date + timer->period_ms;
+            }
+            Luos_SiftTimer(0);
+        }
+        else
+        {
+            Luos_TimerStop(timer);
+        }
+        // The callback can start or stop timers
+        timer->callback(timer->container, timer);
+        called = true;
+    }
+    return called;
+}
+/******************************************************************************
+ * @brief Move a timer to its place in the heap
+ * @param index of the timer to move
+ * @return None
+ ******************************************************************************/
+static void Luos_SiftTimer(uint16_t index)
+{
+    luos_timer_t *moved = timer_heap[index];
+    // Go up while the parent is later
+    while (index > 0)
+    {
+        uint16_t parent = (index - 1) / 2;
+        if ((int32_t)(timer_heap[parent]->deadline - moved->deadline) <= 0)
+        {
+            break;
+        }
+        timer_heap[index]             = timer_heap[parent];
+        timer_heap[index]->heap_index = index;
+        index                         = parent;
+    }
+    // Go down while a child is sooner
+    while ((2 * index + 1) < timer_number)
+    {
+        uint16_t child = 2 * index + 1;
+        if (((child + 1) < timer_number) && ((int32_t)(timer_heap[child + 1]->deadline - timer_heap[child]->deadline) < 0))
+        {
+            child++;
+        }
+        if ((int32_t)(moved->deadline - timer_heap[child]->deadline) <= 0)
+        {
+            break;
+        }
+        timer_heap[index]             = timer_heap[child];
+        timer_heap[index]->heap_index = index;
+        index                         = child;
+    }
+    timer_heap[index] = moved;
+    moved->heap_index = index;
+}
 /******************************************************************************
  * @brief return True if all message are complete
  * @param None
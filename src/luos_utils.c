@@ -27,6 +27,17 @@ __attribute__((weak)) void node_assert(char *file, uint32_t line)
     return;
 }
 
+/******************************************************************************
+ * @brief This function can be redefine by users to wake up a sleeping node
+ * It is called from IRQ when a message is received or a transmission end.
+ * @param None
+ * @return None
+ ******************************************************************************/
+__attribute__((weak)) void node_wakeup(void)
+{
+    return;
+}
+
 /******************************************************************************
  * @brief Luos assertion management
  * @param file name as a string
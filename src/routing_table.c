@@ -16,22 +16,166 @@
  * Definitions
  ******************************************************************************/
 #define ALIAS_SIZE 15
+
+// FNV-1a hash
+#define RTB_HASH_INIT  2166136261
+#define RTB_HASH_PRIME 16777619
+
+// Size of the hash table used to find duplicated aliases
+#define RTB_NAME_HASH_SIZE (MAX_RTB_CONTAINER * 2)
+
+/* Compact routing_table frame format (RTB_SHARE command):
+ * Each frame starts with the content hash (4 bytes), the epoch (2 bytes) and the frame index (2 bytes, bit 15 set on the last frame)
+ * followed by records. Records never span frames and the compression context is reset on each frame.
+ * Node record      : tag, varint node_id, varint ports (trailing null ports are elided)
+ * Container record : tag, [varint id], [varint type], alias byte, alias characters, [varint alias suffix]
+ * The alias byte contain the number of characters shared with the previous alias base (high nibble)
+ * and the number of following characters (low nibble).
+ */
+#define RTB_FRAME_HEADER_SIZE   8
+#define RTB_FRAME_LAST          0x8000
+#define RTB_RECORD_KIND_MASK    0x03
+#define RTB_RECORD_NODE         0x00
+#define RTB_RECORD_CONTAINER    0x01
+#define RTB_NODE_CERTIFIED      0x04
+#define RTB_NODE_PORT_SHIFT     3
+#define RTB_CONTAINER_NEXT_ID   0x04 // id is the previous one + 1
+#define RTB_CONTAINER_SAME_TYPE 0x08 // type is the same than the previous one
+#define RTB_CONTAINER_SUFFIX    0x10 // an alias suffix follow the alias
+#define RTB_RECORD_MAX_SIZE     (1 + 3 + (MAX_RTB_NODE_PORT * 3) + 3 + ALIAS_SIZE + 3)
+
+/* Routing_table delta format (RTB_DELTA command):
+ * Epoch (2 bytes) and content hash (4 bytes) of the routing_table after the modification,
+ * operation (1 byte), varint container id, then depending on the operation :
+ * RTB_DELTA_ADD    : varint node_id, varint type, alias size, alias characters
+ * RTB_DELTA_REMOVE : nothing
+ * RTB_DELTA_RENAME : alias size, alias characters
+ * Nodes acknowledge deltas with their epoch and content hash (RTB_EPOCH command).
+ */
+#define RTB_DELTA_HEADER_SIZE 6
+
+typedef enum
+{
+    RTB_DELTA_ADD,
+    RTB_DELTA_REMOVE,
+    RTB_DELTA_RENAME
+} rtb_delta_op_t;
+
+// Compression context of a frame
+typedef struct
+{
+    uint16_t id;                // Previous container id
+    uint16_t type;              // Previous container type
+    char alias[MAX_ALIAS_SIZE]; // Previous container alias base
+} rtb_codec_t;
+
+// Routing_table generation, driven by introduction replies and a timeout timer
+typedef struct
+{
+    container_t *container; // Container running the detection, 0 when no generation is running
+    uint16_t nb_node;       // Number of nodes found by the topology detection
+    uint16_t try_nb;        // Number of introductions asked
+    luos_timer_t timer;     // Introduction reply timeout
+} rtb_generation_t;
+
+// Routing_table share, frames are sent from Luos_Loop as the messages memory allows
+typedef struct
+{
+    container_t *container; // Container sharing the routing_table, 0 when no share is running
+    uint16_t entry;         // Next entry to add to a frame
+    uint16_t node;          // Next node to add to a frame
+    uint16_t index;         // Next container to add to a frame
+    uint16_t frame_index;   // Index of the frame being built
+    uint8_t frame_ready;    // True if the frame is complete and waiting for memory to be sent
+    uint32_t start_date;    // Date of the first try to send the ready frame
+    rtb_codec_t codec;      // Compression context of the frame being built
+    msg_t msg;              // Frame being built
+    luos_timer_t timer;     // Try again to send the frame when messages memory is full
+} rtb_share_t;
+
+#define RTB_INTRO_TIMEOUT_MS 15
+#define RTB_SHARE_RETRY_MS   1   // Time before trying again to send a frame when messages memory is full
+#define RTB_SHARE_TIMEOUT_MS 500 // Maximum time to get memory for a frame
 /*******************************************************************************
  * Variables
  ******************************************************************************/
-routing_table_t routing_table[MAX_RTB_ENTRY];
-volatile uint16_t last_container           = 0;
-volatile uint16_t last_routing_table_entry = 0;
+rtb_node_t rtb_nodes[MAX_RTB_NODE];                // Nodes of the routing_table
+rtb_container_t rtb_containers[MAX_RTB_CONTAINER]; // Containers of the routing_table
+char rtb_alias_pool[RTB_ALIAS_POOL_SIZE];          // Aliases bases memory
+uint16_t rtb_alias_hash[RTB_ALIAS_HASH_SIZE];      // Alias pool position + 1 of aliases bases (0 for free slot)
+uint16_t rtb_name_hash[RTB_NAME_HASH_SIZE];        // Aliases de-duplication: container index + 1 of each alias already given
+uint16_t rtb_next_suffix[RTB_ALIAS_HASH_SIZE];     // Aliases de-duplication: first number to try for each alias base
+volatile uint16_t rtb_node_nb      = 0;
+volatile uint16_t rtb_container_nb = 0;
+uint16_t rtb_alias_pool_size       = 0;
+volatile uint16_t last_container   = 0;
+char rtb_alias_buffer[MAX_ALIAS_SIZE]; // Alias returned by RoutingTB_AliasFromId
+
+// Routing table reception session
+routing_table_t rtb_rx_entry;
+uint16_t rtb_rx_entry_size     = 0;
+uint16_t rtb_rx_remaining_size = 0;
+
+// Compact routing_table content hash and reception session
+uint32_t rtb_hash     = 0;
+uint32_t rtb_rx_hash  = 0;
+uint16_t rtb_rx_frame = 0xFFFF;
+
+// Routing_table versions
+uint16_t rtb_epoch   = 0;     // Network epoch, shared by all nodes having the same routing_table
+uint16_t rtb_version = 1;     // Local version, changed on each routing_table modification
+bool rtb_reshared    = false; // The routing_table have been shared again for this epoch
+
+// Precomputed search lists, rebuilt each time the routing_table change.
+uint16_t rtb_type_list[MAX_RTB_CONTAINER];   // Containers indexes sorted by type
+uint16_t rtb_sensor_list[MAX_RTB_CONTAINER]; // Sensors containers indexes
+uint16_t rtb_sensor_nb = 0;
+
+// Routing_table generation and share in progress
+rtb_generation_t rtb_generation = {0};
+rtb_share_t rtb_share           = {0};
 /*******************************************************************************
  * Function
  ******************************************************************************/
-static void RoutingTB_AddNumToAlias(char *alias, uint8_t num);
 static uint16_t RoutingTB_BigestID(void);
 static uint16_t RoutingTB_BigestNodeID(void);
-static bool RoutingTB_WaitRoutingTable(container_t *container, msg_t *intro_msg);
+static void RoutingTB_AskIntroduction(void);
+static void RoutingTB_IntroductionTimeout(container_t *container, luos_timer_t *timer);
+static void RoutingTB_EndGeneration(void);
+static void RoutingTB_ComputeSearchLists(void);
+static uint16_t RoutingTB_ContainerIndexFromID(uint16_t id);
+static uint16_t RoutingTB_NodeContainerEnd(uint16_t node_index);
+static uint16_t RoutingTB_StoreAlias(const char *alias);
+static void RoutingTB_CompactAliases(void);
+static uint16_t RoutingTB_InternAlias(const char *alias);
+static void RoutingTB_BuildAlias(const rtb_container_t *container, char *alias);
+static uint16_t RoutingTB_AliasSlot(uint16_t position);
+static void RoutingTB_DeduplicateAliases(void);
+static void RoutingTB_NodeToEntry(uint16_t node_index, routing_table_t *entry);
+static void RoutingTB_ContainerToEntry(uint16_t container_index, routing_table_t *entry);
+static void RoutingTB_RemoveContainers(uint16_t container_index, uint16_t nb);
+static error_return_t RoutingTB_AddNode(uint16_t node_id, uint8_t certified, const uint16_t *port_table, uint16_t port_nb);
+static error_return_t RoutingTB_AddContainer(uint16_t id, uint16_t type, const char *alias, uint16_t alias_suffix);
+static uint32_t RoutingTB_Hash(uint32_t hash, const uint8_t *data, uint16_t size);
+static uint32_t RoutingTB_ComputeHash(void);
+static uint8_t RoutingTB_WriteVarint(uint8_t *data, uint16_t value);
+static error_return_t RoutingTB_ReadVarint(const msg_t *msg, uint16_t *position, uint16_t *value);
+static void RoutingTB_ResetCodec(rtb_codec_t *codec);
+static uint8_t RoutingTB_EncodeNode(uint16_t node_index, uint8_t *record);
+static uint8_t RoutingTB_EncodeContainer(uint16_t container_index, uint8_t *record, rtb_codec_t *codec);
+static error_return_t RoutingTB_DecodeFrame(msg_t *msg);
+static void RoutingTB_Send(container_t *container, msg_t *msg);
+static void RoutingTB_SetEpoch(uint16_t epoch);
+static uint8_t RoutingTB_WriteAlias(uint8_t *data, const char *alias);
+static error_return_t RoutingTB_ReadAlias(const msg_t *msg, uint16_t *position, char *alias);
+static error_return_t RoutingTB_InsertContainer(uint16_t node_id, uint16_t id, uint16_t type, const char *alias);
+static error_return_t RoutingTB_ApplyDelta(msg_t *msg);
+static error_return_t RoutingTB_SendDelta(container_t *container, msg_t *msg);
 
 static void RoutingTB_Generate(container_t *container, uint16_t nb_node);
-static void RoutingTB_Share(container_t *container, uint16_t nb_node);
+static void RoutingTB_Share(container_t *container);
+static void RoutingTB_ShareFrames(void);
+static void RoutingTB_ShareRetry(container_t *container, luos_timer_t *timer);
 
 // ************************ routing_table search tools ***************************
 
@@ -42,16 +186,15 @@ static void RoutingTB_Share(container_t *container, uint16_t nb_node);
  ******************************************************************************/
 uint16_t RoutingTB_IDFromAlias(char *alias)
 {
+    char container_alias[MAX_ALIAS_SIZE];
     if (*alias != -1)
     {
-        for (int i = 0; i <= last_routing_table_entry; i++)
+        for (uint16_t i = 0; i < rtb_container_nb; i++)
         {
-            if (routing_table[i].mode == CONTAINER)
+            RoutingTB_BuildAlias(&rtb_containers[i], container_alias);
+            if (strncmp(container_alias, alias, MAX_ALIAS_SIZE) == 0)
             {
-                if (strcmp(routing_table[i].alias, alias) == 0)
-                {
-                    return routing_table[i].id;
-                }
+                return rtb_containers[i].id;
             }
         }
     }
@@ -64,17 +207,8 @@ uint16_t RoutingTB_IDFromAlias(char *alias)
  ******************************************************************************/
 uint16_t RoutingTB_IDFromType(luos_type_t type)
 {
-    for (int i = 0; i <= last_routing_table_entry; i++)
-    {
-        if (routing_table[i].mode == CONTAINER)
-        {
-            if (type == routing_table[i].type)
-            {
-                return routing_table[i].id;
-            }
-        }
-    }
-    return 0xFFFF;
+    rtb_iterator_t iterator = RoutingTB_IterateType(type);
+    return RoutingTB_IteratorNext(&iterator);
 }
 /******************************************************************************
  * @brief  Return an id from container
@@ -84,7 +218,7 @@ uint16_t RoutingTB_IDFromType(luos_type_t type)
 uint16_t RoutingTB_IDFromContainer(container_t *container)
 {
     // make sure route table is clean before sharing id
-    if (last_routing_table_entry == 0)
+    if (RoutingTB_GetLastEntry() == 0)
     {
         return 0;
     }
@@ -92,20 +226,17 @@ uint16_t RoutingTB_IDFromContainer(container_t *container)
 }
 /******************************************************************************
  * @brief  Return container Alias from ID
+ * The returned string is valid until the next call of this function.
  * @param id container look at
  * @return pointer to string or Error
  ******************************************************************************/
 char *RoutingTB_AliasFromId(uint16_t id)
 {
-    for (int i = 0; i <= last_routing_table_entry; i++)
+    uint16_t index = RoutingTB_ContainerIndexFromID(id);
+    if (index < rtb_container_nb)
     {
-        if (routing_table[i].mode == CONTAINER)
-        {
-            if (id == routing_table[i].id)
-            {
-                return routing_table[i].alias;
-            }
-        }
+        RoutingTB_BuildAlias(&rtb_containers[index], rtb_alias_buffer);
+        return rtb_alias_buffer;
     }
     return (char *)0;
 }
@@ -116,15 +247,10 @@ char *RoutingTB_AliasFromId(uint16_t id)
  ******************************************************************************/
 luos_type_t RoutingTB_TypeFromID(uint16_t id)
 {
-    for (uint16_t i = 0; i <= last_routing_table_entry; i++)
+    uint16_t index = RoutingTB_ContainerIndexFromID(id);
+    if (index < rtb_container_nb)
     {
-        if (routing_table[i].mode == CONTAINER)
-        {
-            if (routing_table[i].id == id)
-            {
-                return routing_table[i].type;
-            }
-        }
+        return rtb_containers[index].type;
     }
     return -1;
 }
@@ -226,14 +352,11 @@ uint8_t RoutingTB_ContainerIsSensor(luos_type_t type)
 static uint16_t RoutingTB_BigestID(void)
 {
     uint16_t max_id = 0;
-    for (uint16_t i = 0; i < last_routing_table_entry; i++)
+    for (uint16_t i = 0; i < rtb_container_nb; i++)
     {
-        if (routing_table[i].mode == CONTAINER)
+        if (rtb_containers[i].id > max_id)
         {
-            if (routing_table[i].id > max_id)
-            {
-                max_id = routing_table[i].id;
-            }
+            max_id = rtb_containers[i].id;
         }
     }
     return max_id;
@@ -246,18 +369,49 @@ static uint16_t RoutingTB_BigestID(void)
 static uint16_t RoutingTB_BigestNodeID(void)
 {
     uint16_t max_id = 0;
-    for (uint16_t i = 0; i < last_routing_table_entry; i++)
+    for (uint16_t i = 0; i < rtb_node_nb; i++)
     {
-        if (routing_table[i].mode == NODE)
+        if (rtb_nodes[i].node_id > max_id)
         {
-            if (routing_table[i].node_id > max_id)
-            {
-                max_id = routing_table[i].node_id;
-            }
+            max_id = rtb_nodes[i].node_id;
         }
     }
     return max_id;
 }
+/******************************************************************************
+ * @brief  find the index of a container into the routing_table
+ * @param id of the container look at
+ * @return index or rtb_container_nb if not found
+ ******************************************************************************/
+static uint16_t RoutingTB_ContainerIndexFromID(uint16_t id)
+{
+    // IDs are given in routing_table order by the detection, check this place first.
+    if ((id > 0) && (id <= rtb_container_nb) && (rtb_containers[id - 1].id == id))
+    {
+        return id - 1;
+    }
+    for (uint16_t i = 0; i < rtb_container_nb; i++)
+    {
+        if (rtb_containers[i].id == id)
+        {
+            return i;
+        }
+    }
+    return rtb_container_nb;
+}
+/******************************************************************************
+ * @brief  get the index following the last container of a node
+ * @param node_index index of the node look at
+ * @return container index
+ ******************************************************************************/
+static uint16_t RoutingTB_NodeContainerEnd(uint16_t node_index)
+{
+    if ((node_index + 1) < rtb_node_nb)
+    {
+        return rtb_nodes[node_index + 1].first_container;
+    }
+    return rtb_container_nb;
+}
 
 /******************************************************************************
  * @brief  get number of a node on network
@@ -266,15 +420,7 @@ static uint16_t RoutingTB_BigestNodeID(void)
  ******************************************************************************/
 uint16_t RoutingTB_GetNodeNB(void)
 {
-    uint16_t node_nb = 0;
-    for (uint16_t i = 0; i <= last_routing_table_entry; i++)
-    {
-        if (routing_table[i].mode == NODE)
-        {
-            node_nb++;
-        }
-    }
-    return node_nb - 1;
+    return rtb_node_nb - 1;
 }
 /******************************************************************************
  * @brief  get ID of node on network
@@ -283,289 +429,1604 @@ uint16_t RoutingTB_GetNodeNB(void)
  ******************************************************************************/
 uint16_t RoutingTB_GetNodeID(uint16_t index)
 {
-    return routing_table[index + 1].id;
+    return rtb_nodes[index + 1].node_id;
 }
 
-// ********************* routing_table management tools ************************
+// ********************* routing_table iterators ************************
 
 /******************************************************************************
- * @brief compute entry number
- * @param None
- * @return None
+ * @brief  Create an iterator on all containers of a type
+ * @param type of container look at
+ * @return iterator
  ******************************************************************************/
-void RoutingTB_ComputeRoutingTableEntryNB(void)
+rtb_iterator_t RoutingTB_IterateType(luos_type_t type)
 {
-    for (uint16_t i = 0; i < MAX_RTB_ENTRY; i++)
+    rtb_iterator_t iterator = {.list = rtb_type_list, .first = 0, .nb = 0, .cursor = 0};
+    // rtb_type_list is sorted by type, find the first container of this type
+    uint16_t first = 0;
+    uint16_t last  = rtb_container_nb;
+    while (first < last)
     {
-        if (routing_table[i].mode == CONTAINER)
+        uint16_t middle = (first + last) / 2;
+        if (rtb_containers[rtb_type_list[middle]].type < type)
         {
-            last_container = routing_table[i].id;
+            first = middle + 1;
         }
-        if (routing_table[i].mode == CLEAR)
+        else
         {
-            last_routing_table_entry = i;
-            return;
+            last = middle;
         }
     }
-    // Routing table space is full.
-    last_routing_table_entry = MAX_RTB_ENTRY - 1;
+    iterator.list = &rtb_type_list[first];
+    while (((first + iterator.nb) < rtb_container_nb) && (rtb_containers[rtb_type_list[first + iterator.nb]].type == type))
+    {
+        iterator.nb++;
+    }
+    return iterator;
 }
 /******************************************************************************
- * @brief manage container name increment to never have same alias
- * @param alias to change
- * @param nb to add
- * @return None
+ * @brief  Create an iterator on all containers of a node
+ * @param node_id of the node look at
+ * @return iterator
  ******************************************************************************/
-static void RoutingTB_AddNumToAlias(char *alias, uint8_t num)
+rtb_iterator_t RoutingTB_IterateNode(uint16_t node_id)
 {
-    uint8_t intsize = 1;
-    if (num > 9)
-    {
-        // The string size of num is 2
-        intsize = 2;
-    }
-    if (num > 99) //only 2 digit are alowed when add alias number
+    rtb_iterator_t iterator = {.list = 0, .first = 0, .nb = 0, .cursor = 0};
+    for (uint16_t i = 0; i < rtb_node_nb; i++)
     {
-        // This is probably a mistake, put an error into the alias
-        memset(alias, 0, ALIAS_SIZE);
-        memcpy(alias, "error", strlen("error"));
-        return;
-    }
-    // Change size to fit into 15 characters
-    if (strlen(alias) > (ALIAS_SIZE - intsize))
-    {
-        alias[(ALIAS_SIZE - intsize)] = '\0';
+        if (rtb_nodes[i].node_id == node_id)
+        {
+            // Containers of a node are contiguous into the routing_table
+            iterator.first = rtb_nodes[i].first_container;
+            iterator.nb    = RoutingTB_NodeContainerEnd(i) - rtb_nodes[i].first_container;
+            break;
+        }
     }
-    else
+    return iterator;
+}
+/******************************************************************************
+ * @brief  Create an iterator on all sensors containers
+ * @param None
+ * @return iterator
+ ******************************************************************************/
+rtb_iterator_t RoutingTB_IterateSensors(void)
+{
+    rtb_iterator_t iterator = {.list = rtb_sensor_list, .first = 0, .nb = rtb_sensor_nb, .cursor = 0};
+    return iterator;
+}
+/******************************************************************************
+ * @brief  Get the next container of an iterator
+ * Iterators are invalidated by any routing_table modification.
+ * @param iterator pointer
+ * @return ID or Error if there is no more container
+ ******************************************************************************/
+uint16_t RoutingTB_IteratorNext(rtb_iterator_t *iterator)
+{
+    if (iterator->cursor < iterator->nb)
     {
-        alias[strlen(alias)] = '\0';
+        if (iterator->list)
+        {
+            return rtb_containers[iterator->list[iterator->cursor++]].id;
+        }
+        return rtb_containers[iterator->first + iterator->cursor++].id;
     }
-    // Add a number at the end of the alias
-    sprintf(alias, "%s%d", alias, num);
+    return 0xFFFF;
+}
+/******************************************************************************
+ * @brief  Check if a container have to be placed after another one into the type list
+ * @param index of the container to place
+ * @param other index of the container to compare with
+ * @return true if index is after other
+ ******************************************************************************/
+static inline bool RoutingTB_IsTypeAfter(uint16_t index, uint16_t other)
+{
+    // Containers of the same type stay in routing_table order.
+    return (rtb_containers[index].type > rtb_containers[other].type)
+           || ((rtb_containers[index].type == rtb_containers[other].type) && (index > other));
 }
 /******************************************************************************
- * @brief time out to receive en route table from
- * @param container receive
- * @param intro msg in route table
+ * @brief  Rebuild all search lists from the routing_table content
+ * @param None
  * @return None
  ******************************************************************************/
-static bool RoutingTB_WaitRoutingTable(container_t *container, msg_t *intro_msg)
+static void RoutingTB_ComputeSearchLists(void)
 {
-    const uint8_t timeout    = 15; // timeout in ms
-    const uint16_t entry_bkp = last_routing_table_entry;
-    Luos_SendMsg(container, intro_msg);
-    uint32_t timestamp = LuosHAL_GetSystick();
-    while ((LuosHAL_GetSystick() - timestamp) < timeout)
+    // The routing_table changed, invalidate caches
+    rtb_version++;
+    if (rtb_version == 0)
     {
-        // If this request is for a container in this board allow him to respond.
-        Luos_Loop();
-        if (entry_bkp != last_routing_table_entry)
+        rtb_version = 1;
+    }
+    rtb_sensor_nb = 0;
+    for (uint16_t i = 0; i < rtb_container_nb; i++)
+    {
+        rtb_type_list[i] = i;
+        if (RoutingTB_ContainerIsSensor(rtb_containers[i].type))
+        {
+            rtb_sensor_list[rtb_sensor_nb++] = i;
+        }
+    }
+    // Sort the type list (shell sort)
+    uint16_t gap = 1;
+    while (gap < (rtb_container_nb / 3))
+    {
+        gap = (gap * 3) + 1;
+    }
+    for (; gap > 0; gap /= 3)
+    {
+        for (uint16_t i = gap; i < rtb_container_nb; i++)
         {
-            return true;
+            uint16_t index = rtb_type_list[i];
+            uint16_t j     = i;
+            while ((j >= gap) && RoutingTB_IsTypeAfter(rtb_type_list[j - gap], index))
+            {
+                rtb_type_list[j] = rtb_type_list[j - gap];
+                j -= gap;
+            }
+            rtb_type_list[j] = index;
         }
     }
-    return false;
 }
+
+// ********************* routing_table alias pool ************************
+
 /******************************************************************************
- * @brief Generate Complete route table with local route table receive
- * @param container in node
- * @param node number on network
- * @return None
+ * @brief  Store an alias base into the alias pool
+ * If the same alias base is already stored it is reused.
+ * @param alias to store
+ * @return alias position into the pool or Error if the pool is full
  ******************************************************************************/
-static void RoutingTB_Generate(container_t *container, uint16_t nb_node)
+static uint16_t RoutingTB_StoreAlias(const char *alias)
 {
-    // Asks for introduction for every found node (even the one detecting).
-    uint16_t try_nb       = 0;
-    uint16_t last_node_id = RoutingTB_BigestNodeID();
-    uint16_t last_cont_id = 0;
-    msg_t intro_msg;
-    while ((last_node_id < nb_node) && (try_nb < nb_node))
-    {
-        try_nb++;
-        intro_msg.header.cmd         = RTB_CMD;
-        intro_msg.header.target_mode = NODEIDACK;
-        // Target next unknown node
-        intro_msg.header.target = last_node_id + 1;
-        // set the first container id it can use
-        intro_msg.header.size = 2;
-        last_cont_id          = RoutingTB_BigestID() + 1;
-        memcpy(intro_msg.data, &last_cont_id, sizeof(uint16_t));
-        // Ask to introduce and wait for a reply
-        if (!RoutingTB_WaitRoutingTable(container, &intro_msg))
-        {
-            // We don't get the answer
-            nb_node = last_node_id;
-            break;
-        }
-        last_node_id = RoutingTB_BigestNodeID();
+    uint16_t size = 0;
+    while ((size < ALIAS_SIZE) && (alias[size] != '\0'))
+    {
+        size++;
     }
-    // Check Alias duplication.
-    uint16_t nb_mod = RoutingTB_BigestID();
-    for (uint16_t id = 1; id <= nb_mod; id++)
-    {
-        uint16_t found_id = RoutingTB_IDFromAlias(RoutingTB_AliasFromId(id));
-        if ((found_id != id) & (found_id != -1))
-        {
-            // The found_id don't match with the actual ID of the container because the alias already exist
-            // Find the new alias to give him
-            uint8_t annotation              = 1;
-            char base_alias[MAX_ALIAS_SIZE] = {0};
-            memcpy(base_alias, RoutingTB_AliasFromId(id), MAX_ALIAS_SIZE);
-            // Add a number after alias in routing table
-            RoutingTB_AddNumToAlias(RoutingTB_AliasFromId(id), annotation++);
-            // check another time if this alias is already used
-            while (RoutingTB_IDFromAlias(RoutingTB_AliasFromId(id)) != id)
+    uint16_t slot = RoutingTB_Hash(RTB_HASH_INIT, (const uint8_t *)alias, size) % RTB_ALIAS_HASH_SIZE;
+    for (uint16_t probe = 0; probe < RTB_ALIAS_HASH_SIZE; probe++)
+    {
+        if (rtb_alias_hash[slot] == 0)
+        {
+            // This is a new alias, add it into the pool
+            if ((rtb_alias_pool_size + size + 1) > RTB_ALIAS_POOL_SIZE)
             {
-                // This alias is already used.
-                // Remove the number previously setuped by overwriting it with the base_alias
-                memcpy(RoutingTB_AliasFromId(id), base_alias, MAX_ALIAS_SIZE);
-                RoutingTB_AddNumToAlias(RoutingTB_AliasFromId(id), annotation++);
+                return 0xFFFF;
             }
+            uint16_t position = rtb_alias_pool_size;
+            memcpy(&rtb_alias_pool[position], alias, size);
+            rtb_alias_pool[position + size] = '\0';
+            rtb_alias_pool_size += size + 1;
+            rtb_alias_hash[slot] = position + 1;
+            return position;
+        }
+        uint16_t position = rtb_alias_hash[slot] - 1;
+        if ((strncmp(&rtb_alias_pool[position], alias, size) == 0) && (rtb_alias_pool[position + size] == '\0'))
+        {
+            return position;
         }
+        slot = (slot + 1) % RTB_ALIAS_HASH_SIZE;
     }
+    return 0xFFFF;
 }
 /******************************************************************************
- * @brief Send the complete route table to each node on the network
- * @param container who send
- * @param node number on network
+ * @brief  Remove the alias bases no container use anymore from the alias pool
+ * Removed or renamed containers leave their alias base into the pool, the used ones
+ * are moved to the pool start and the containers aliases positions are updated.
+ * @param None
  * @return None
  ******************************************************************************/
-static void RoutingTB_Share(container_t *container, uint16_t nb_node)
+static void RoutingTB_CompactAliases(void)
 {
-    // send route table to each nodes. Routing tables are commonly usable for each containers of a node.
-    msg_t intro_msg;
-    intro_msg.header.cmd         = RTB_CMD;
-    intro_msg.header.target_mode = NODEIDACK;
-
-    for (uint16_t i = 2; i <= nb_node; i++) //don't send to ourself
+    uint16_t size     = 0;
+    uint16_t position = 0;
+    memset(rtb_alias_hash, 0, sizeof(rtb_alias_hash));
+    while (position < rtb_alias_pool_size)
     {
-        intro_msg.header.target = i;
-        Luos_SendData(container, &intro_msg, routing_table, (last_routing_table_entry * sizeof(routing_table_t)));
+        uint16_t length = strlen(&rtb_alias_pool[position]) + 1;
+        bool used       = false;
+        // Moved positions are lower than the next ones, a container can't be moved twice.
+        for (uint16_t i = 0; i < rtb_container_nb; i++)
+        {
+            if (rtb_containers[i].alias == position)
+            {
+                rtb_containers[i].alias = size;
+                used                    = true;
+            }
+        }
+        if (used)
+        {
+            memmove(&rtb_alias_pool[size], &rtb_alias_pool[position], length);
+            uint16_t slot = RoutingTB_Hash(RTB_HASH_INIT, (const uint8_t *)&rtb_alias_pool[size], length - 1) % RTB_ALIAS_HASH_SIZE;
+            while (rtb_alias_hash[slot] != 0)
+            {
+                slot = (slot + 1) % RTB_ALIAS_HASH_SIZE;
+            }
+            rtb_alias_hash[slot] = size + 1;
+            size += length;
+        }
+        position += length;
     }
+    rtb_alias_pool_size = size;
 }
-
 /******************************************************************************
- * @brief Detect all containers and create a route table with it.
- * If multiple containers have the same name it will be changed with a number in it
- * Automatically at the end this function create a list of sensors id
- * @param container who send
- * @return None
+ * @brief  Store an alias base into the alias pool, compacting the pool if it is full
+ * Compaction move the alias bases, the containers being added must be counted into
+ * the routing_table only after this call.
+ * @param alias to store
+ * @return alias position into the pool or Error if the pool is full
  ******************************************************************************/
-void RoutingTB_DetectContainers(container_t *container)
+static uint16_t RoutingTB_InternAlias(const char *alias)
 {
-    // Starts the topology detection.
-    uint16_t nb_node = Robus_TopologyDetection(container->ll_container);
-    // clear the routing table.
-    RoutingTB_Erase();
-    // Generate the routing_table
-    RoutingTB_Generate(container, nb_node);
-    // We have a complete routing table now share it with others.
-    RoutingTB_Share(container, nb_node);
+    uint16_t position = RoutingTB_StoreAlias(alias);
+    if (position == 0xFFFF)
+    {
+        RoutingTB_CompactAliases();
+        position = RoutingTB_StoreAlias(alias);
+    }
+    return position;
 }
 /******************************************************************************
- * @brief entry in routable node with associate container
- * @param route table
- * @param node structure
+ * @brief  Create the complete alias of a container
+ * The alias base is truncated to keep the number into 15 characters.
+ * @param container to get the alias from
+ * @param alias string of MAX_ALIAS_SIZE to fill
  * @return None
  ******************************************************************************/
-void RoutingTB_ConvertNodeToRoutingTable(routing_table_t *entry, node_t *node)
+static void RoutingTB_BuildAlias(const rtb_container_t *container, char *alias)
 {
-    // Check if the NBR_PORT config is too high to fit into routing table.
-    LUOS_ASSERT(sizeof(node_t) <= (sizeof(routing_table_t) - 1));
-    memset(entry, 0, sizeof(routing_table_t));
-    entry->mode = NODE;
-    memcpy(entry->unmap_data, node->unmap, sizeof(node_t));
+    memset(alias, 0, MAX_ALIAS_SIZE);
+    if (container->alias == 0xFFFF)
+    {
+        // This alias didn't fit into the pool
+        return;
+    }
+    strncpy(alias, &rtb_alias_pool[container->alias], ALIAS_SIZE);
+    if (container->alias_suffix == 0)
+    {
+        return;
+    }
+    // Change size to fit the number into 15 characters
+    uint8_t intsize = 1;
+    for (uint16_t value = container->alias_suffix; value > 9; value /= 10)
+    {
+        intsize++;
+    }
+    if (strlen(alias) > (size_t)(ALIAS_SIZE - intsize))
+    {
+        alias[(ALIAS_SIZE - intsize)] = '\0';
+    }
+    // Add a number at the end of the alias
+    sprintf(&alias[strlen(alias)], "%d", container->alias_suffix);
 }
 /******************************************************************************
- * @brief entry in routable container associate to a node
- * @param route table
- * @param container in node
- * @return None
+ * @brief  Find the alias hash table slot of an alias base
+ * @param position of the alias base into the pool
+ * @return slot
  ******************************************************************************/
-void RoutingTB_ConvertContainerToRoutingTable(routing_table_t *entry, container_t *container)
+static uint16_t RoutingTB_AliasSlot(uint16_t position)
 {
-    entry->type = container->ll_container->type;
-    entry->id   = container->ll_container->id;
-    entry->mode = CONTAINER;
-    for (uint8_t i = 0; i < MAX_ALIAS_SIZE; i++)
+    const char *alias = &rtb_alias_pool[position];
+    uint16_t slot     = RoutingTB_Hash(RTB_HASH_INIT, (const uint8_t *)alias, strlen(alias)) % RTB_ALIAS_HASH_SIZE;
+    while (rtb_alias_hash[slot] != (position + 1))
     {
-        entry->alias[i] = container->alias[i];
+        slot = (slot + 1) % RTB_ALIAS_HASH_SIZE;
     }
+    return slot;
 }
 /******************************************************************************
- * @brief remove an entire node
- * @param route table
+ * @brief  Add a number after duplicated aliases to never have same alias
+ * The first container keep its alias, the next ones get the first free number.
+ * @param None
  * @return None
  ******************************************************************************/
-void RoutingTB_RemoveNode(uint16_t nodeid)
+static void RoutingTB_DeduplicateAliases(void)
 {
-    // instead of removing a node just remove all the container in it to make it unusable
-    // We could add a param (CONTROL for example) to declare the node as STOP
-    // find the node
-    for (uint16_t i = 0; i < last_routing_table_entry; i++)
+    char alias[MAX_ALIAS_SIZE];
+    char used_alias[MAX_ALIAS_SIZE];
+    // Scratch tables are globals, they are too big for the stack of a node with many containers
+    memset(rtb_name_hash, 0, sizeof(rtb_name_hash));
+    memset(rtb_next_suffix, 0, sizeof(rtb_next_suffix));
+    for (uint16_t i = 0; i < rtb_container_nb; i++)
     {
-        if (routing_table[i].mode == NODE)
+        rtb_container_t *container = &rtb_containers[i];
+        if (container->alias == 0xFFFF)
+        {
+            // This alias didn't fit into the pool
+            continue;
+        }
+        // Numbers lower than next_suffix are already used, don't try them again.
+        uint16_t base_slot      = RoutingTB_AliasSlot(container->alias);
+        uint16_t slot           = 0;
+        container->alias_suffix = rtb_next_suffix[base_slot];
+        do
         {
-            if (routing_table[i].node_id == nodeid)
+            RoutingTB_BuildAlias(container, alias);
+            // Look for this alias into the given ones
+            slot = RoutingTB_Hash(RTB_HASH_INIT, (const uint8_t *)alias, strlen(alias)) % RTB_NAME_HASH_SIZE;
+            while (rtb_name_hash[slot] != 0)
             {
-                i++;
-                // We find our node remove all containers
-                while (routing_table[i].mode == CONTAINER)
+                RoutingTB_BuildAlias(&rtb_containers[rtb_name_hash[slot] - 1], used_alias);
+                if (strcmp(alias, used_alias) == 0)
                 {
-                    RoutingTB_RemoveOnRoutingTable(i);
+                    // This alias is already used, try the next number
+                    container->alias_suffix++;
+                    break;
                 }
-                return;
+                slot = (slot + 1) % RTB_NAME_HASH_SIZE;
             }
-        }
+        } while (rtb_name_hash[slot] != 0);
+        rtb_name_hash[slot]        = i + 1;
+        rtb_next_suffix[base_slot] = container->alias_suffix + 1;
     }
 }
+
+// ********************* routing_table management tools ************************
+
 /******************************************************************************
- * @brief remove an entry from routing_table
- * @param index of container
+ * @brief compute entry number
+ * @param None
  * @return None
  ******************************************************************************/
-void RoutingTB_RemoveOnRoutingTable(uint16_t index)
+void RoutingTB_ComputeRoutingTableEntryNB(void)
 {
-    LUOS_ASSERT(index < last_routing_table_entry);
-    memcpy(&routing_table[index], &routing_table[index + 1], sizeof(routing_table_t) * (last_routing_table_entry - (index + 1)));
-    last_routing_table_entry--;
-    memset(&routing_table[last_routing_table_entry], 0, sizeof(routing_table_t));
+    last_container = 0;
+    if (rtb_container_nb)
+    {
+        last_container = rtb_containers[rtb_container_nb - 1].id;
+    }
+    RoutingTB_ComputeSearchLists();
 }
 /******************************************************************************
- * @brief eras erouting_table
+ * @brief ask the next unknown node to introduce itself or end the generation
+ * The generation continue on the introduction reply or on its timeout.
  * @param None
  * @return None
  ******************************************************************************/
-void RoutingTB_Erase(void)
+static void RoutingTB_AskIntroduction(void)
 {
-    memset(routing_table, 0, sizeof(routing_table));
-    last_container           = 0;
-    last_routing_table_entry = 0;
+    uint16_t last_node_id = RoutingTB_BigestNodeID();
+    uint16_t last_cont_id = 0;
+    msg_t intro_msg;
+    if ((last_node_id >= rtb_generation.nb_node) || (rtb_generation.try_nb >= rtb_generation.nb_node))
+    {
+        // Every node introduced itself
+        RoutingTB_EndGeneration();
+        return;
+    }
+    rtb_generation.try_nb++;
+    intro_msg.header.cmd         = RTB_CMD;
+    intro_msg.header.target_mode = NODEIDACK;
+    // Target next unknown node
+    intro_msg.header.target = last_node_id + 1;
+    // set the first container id it can use
+    intro_msg.header.size = 2;
+    last_cont_id          = RoutingTB_BigestID() + 1;
+    memcpy(intro_msg.data, &last_cont_id, sizeof(uint16_t));
+    // Ask to introduce and wait for a reply
+    Luos_TimerStart(rtb_generation.container, &rtb_generation.timer, RTB_INTRO_TIMEOUT_MS, 0, RoutingTB_IntroductionTimeout);
+    Luos_SendMsg(rtb_generation.container, &intro_msg);
 }
 /******************************************************************************
- * @brief get routing_table
- * @param None
- * @return route table
+ * @brief introduction reply timeout, the remaining nodes are ignored
+ * @param container running the detection
+ * @param timer expired
+ * @return None
  ******************************************************************************/
-routing_table_t *RoutingTB_Get(void)
+static void RoutingTB_IntroductionTimeout(container_t *container, luos_timer_t *timer)
 {
-    return routing_table;
+    (void)container;
+    (void)timer;
+    // We don't get the answer
+    RoutingTB_EndGeneration();
 }
 /******************************************************************************
- * @brief return the last ID registered into the routing_table
+ * @brief finish the routing_table generation and share it
  * @param None
- * @return last container ID
+ * @return None
  ******************************************************************************/
-uint16_t RoutingTB_GetLastContainer(void)
+static void RoutingTB_EndGeneration(void)
 {
-    return (uint16_t)last_container;
+    container_t *container   = rtb_generation.container;
+    rtb_generation.container = 0;
+    // Check Alias duplication.
+    RoutingTB_DeduplicateAliases();
+    // This is a new routing_table, start a new epoch
+    RoutingTB_SetEpoch(rtb_epoch + 1);
+    // We have a complete routing table now share it with others.
+    RoutingTB_Share(container);
 }
 /******************************************************************************
- * @brief return the last ID registered into the routing_table
- * @param index of container
- * @return Last entry
+ * @brief Generate Complete route table with local route table receive
+ * The generation runs from Luos_Loop, see RoutingTB_DetectionComplete.
+ * @param container in node
+ * @param node number on network
+ * @return None
  ******************************************************************************/
-uint16_t RoutingTB_GetLastEntry(void)
+static void RoutingTB_Generate(container_t *container, uint16_t nb_node)
+{
+    // Asks for introduction for every found node (even the one detecting).
+    Luos_TimerStop(&rtb_generation.timer);
+    rtb_generation.container = container;
+    rtb_generation.nb_node   = nb_node;
+    rtb_generation.try_nb    = 0;
+    RoutingTB_AskIntroduction();
+}
+/******************************************************************************
+ * @brief compute a FNV-1a hash
+ * @param hash previous hash value (RTB_HASH_INIT to start)
+ * @param data to hash
+ * @param size of data
+ * @return hash
+ ******************************************************************************/
+static uint32_t RoutingTB_Hash(uint32_t hash, const uint8_t *data, uint16_t size)
+{
+    for (uint16_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= RTB_HASH_PRIME;
+    }
+    return hash;
+}
+/******************************************************************************
+ * @brief compute the hash of the routing_table content
+ * @param None
+ * @return hash
+ ******************************************************************************/
+static uint32_t RoutingTB_ComputeHash(void)
 {
-    return (uint16_t)last_routing_table_entry;
+    routing_table_t entry;
+    uint32_t hash = RTB_HASH_INIT;
+    for (uint16_t node = 0; node < rtb_node_nb; node++)
+    {
+        RoutingTB_NodeToEntry(node, &entry);
+        hash = RoutingTB_Hash(hash, (uint8_t *)&entry, sizeof(routing_table_t));
+        for (uint16_t index = rtb_nodes[node].first_container; index < RoutingTB_NodeContainerEnd(node); index++)
+        {
+            RoutingTB_ContainerToEntry(index, &entry);
+            hash = RoutingTB_Hash(hash, (uint8_t *)&entry, sizeof(routing_table_t));
+        }
+    }
+    return hash;
+}
+/******************************************************************************
+ * @brief write a varint
+ * @param data to fill
+ * @param value to write
+ * @return size written
+ ******************************************************************************/
+static uint8_t RoutingTB_WriteVarint(uint8_t *data, uint16_t value)
+{
+    uint8_t size = 0;
+    while (value > 0x7F)
+    {
+        data[size++] = (uint8_t)(value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    data[size++] = (uint8_t)value;
+    return size;
+}
+/******************************************************************************
+ * @brief read a varint from a frame
+ * @param msg frame to read
+ * @param position of the varint, updated to the next data
+ * @param value read
+ * @return Error if the varint is out of the frame
+ ******************************************************************************/
+static error_return_t RoutingTB_ReadVarint(const msg_t *msg, uint16_t *position, uint16_t *value)
+{
+    *value = 0;
+    for (uint8_t shift = 0; shift < 16; shift += 7)
+    {
+        if (*position >= msg->header.size)
+        {
+            return FAILED;
+        }
+        uint8_t byte = msg->data[(*position)++];
+        *value |= (uint16_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return SUCCEED;
+        }
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief reset the compression context at the begining of a frame
+ * @param codec compression context
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_ResetCodec(rtb_codec_t *codec)
+{
+    memset(codec, 0, sizeof(rtb_codec_t));
+    codec->type = 0xFFFF;
+}
+/******************************************************************************
+ * @brief encode a node record
+ * @param node_index index of the node
+ * @param record to fill
+ * @return record size
+ ******************************************************************************/
+static uint8_t RoutingTB_EncodeNode(uint16_t node_index, uint8_t *record)
+{
+    const rtb_node_t *node = &rtb_nodes[node_index];
+    uint8_t size           = 1;
+    // Trailing null ports are not sent
+    uint8_t port_nb = MAX_RTB_NODE_PORT;
+    while ((port_nb > 0) && (node->port_table[port_nb - 1] == 0))
+    {
+        port_nb--;
+    }
+    record[0] = RTB_RECORD_NODE | (port_nb << RTB_NODE_PORT_SHIFT);
+    if (node->certified)
+    {
+        record[0] |= RTB_NODE_CERTIFIED;
+    }
+    size += RoutingTB_WriteVarint(&record[size], node->node_id);
+    for (uint8_t i = 0; i < port_nb; i++)
+    {
+        size += RoutingTB_WriteVarint(&record[size], node->port_table[i]);
+    }
+    return size;
+}
+/******************************************************************************
+ * @brief encode a container record
+ * @param container_index index of the container
+ * @param record to fill
+ * @param codec compression context
+ * @return record size
+ ******************************************************************************/
+static uint8_t RoutingTB_EncodeContainer(uint16_t container_index, uint8_t *record, rtb_codec_t *codec)
+{
+    const rtb_container_t *container = &rtb_containers[container_index];
+    char alias[MAX_ALIAS_SIZE]       = {0};
+    uint8_t size                     = 1;
+    record[0]                        = RTB_RECORD_CONTAINER;
+    if (container->id == (uint16_t)(codec->id + 1))
+    {
+        record[0] |= RTB_CONTAINER_NEXT_ID;
+    }
+    else
+    {
+        size += RoutingTB_WriteVarint(&record[size], container->id);
+    }
+    if (container->type == codec->type)
+    {
+        record[0] |= RTB_CONTAINER_SAME_TYPE;
+    }
+    else
+    {
+        size += RoutingTB_WriteVarint(&record[size], container->type);
+    }
+    // Only send the alias base part which is not shared with the previous one
+    if (container->alias != 0xFFFF)
+    {
+        strncpy(alias, &rtb_alias_pool[container->alias], ALIAS_SIZE);
+    }
+    uint8_t shared = 0;
+    while ((alias[shared] != '\0') && (alias[shared] == codec->alias[shared]))
+    {
+        shared++;
+    }
+    uint8_t length = strlen(&alias[shared]);
+    record[size++] = (shared << 4) | length;
+    memcpy(&record[size], &alias[shared], length);
+    size += length;
+    if (container->alias_suffix)
+    {
+        record[0] |= RTB_CONTAINER_SUFFIX;
+        size += RoutingTB_WriteVarint(&record[size], container->alias_suffix);
+    }
+    codec->id   = container->id;
+    codec->type = container->type;
+    memcpy(codec->alias, alias, MAX_ALIAS_SIZE);
+    return size;
+}
+/******************************************************************************
+ * @brief send a routing_table message
+ * @param container who send
+ * @param msg to send
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_Send(container_t *container, msg_t *msg)
+{
+    uint32_t tickstart = Luos_GetSystick();
+    while (Luos_SendMsg(container, msg) == FAILED)
+    {
+        // No more memory space available
+        Luos_Loop();
+        // 500 here represent 500ms of timeout after start trying to load our data in memory.
+        LUOS_ASSERT(((volatile uint32_t)Luos_GetSystick() - tickstart) < 500);
+    }
+}
+/******************************************************************************
+ * @brief Broadcast the complete route table to all nodes on the network
+ * Nodes already having the same routing_table content ignore it.
+ * Frames are sent from Luos_Loop when messages memory is full, a running share restart.
+ * @param container who send
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_Share(container_t *container)
+{
+    Luos_TimerStop(&rtb_share.timer);
+    rtb_share.container              = container;
+    rtb_share.entry                  = 0;
+    rtb_share.node                   = 0;
+    rtb_share.index                  = 0;
+    rtb_share.frame_index            = 0;
+    rtb_share.frame_ready            = false;
+    rtb_share.msg.header.cmd         = RTB_SHARE;
+    rtb_share.msg.header.target_mode = BROADCAST;
+    rtb_share.msg.header.target      = BROADCAST_VAL;
+    rtb_share.msg.header.size        = RTB_FRAME_HEADER_SIZE;
+    // Save the hash to ignore our own frames
+    rtb_hash = RoutingTB_ComputeHash();
+    memcpy(&rtb_share.msg.data[0], &rtb_hash, sizeof(uint32_t));
+    memcpy(&rtb_share.msg.data[sizeof(uint32_t)], &rtb_epoch, sizeof(uint16_t));
+    RoutingTB_ResetCodec(&rtb_share.codec);
+    RoutingTB_ShareFrames();
+}
+/******************************************************************************
+ * @brief build and send the routing_table frames until messages memory is full
+ * @param None
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_ShareFrames(void)
+{
+    uint8_t record[RTB_RECORD_MAX_SIZE];
+    rtb_codec_t next_codec;
+    msg_t *frame_msg = &rtb_share.msg;
+    while (rtb_share.container != 0)
+    {
+        if (rtb_share.frame_ready == false)
+        {
+            // Records are sent in the legacy routing_table order : each node followed by its containers.
+            while (rtb_share.entry < RoutingTB_GetLastEntry())
+            {
+                bool is_node = (rtb_share.node < rtb_node_nb) && (rtb_nodes[rtb_share.node].first_container <= rtb_share.index);
+                uint8_t size = 0;
+                next_codec   = rtb_share.codec;
+                if (is_node)
+                {
+                    size = RoutingTB_EncodeNode(rtb_share.node, record);
+                }
+                else
+                {
+                    size = RoutingTB_EncodeContainer(rtb_share.index, record, &next_codec);
+                }
+                if ((frame_msg->header.size + size) > MAX_DATA_MSG_SIZE)
+                {
+                    // This record doesn't fit into this frame, it will start the next one.
+                    break;
+                }
+                memcpy(&frame_msg->data[frame_msg->header.size], record, size);
+                frame_msg->header.size += size;
+                rtb_share.codec = next_codec;
+                if (is_node)
+                {
+                    rtb_share.node++;
+                }
+                else
+                {
+                    rtb_share.index++;
+                }
+                rtb_share.entry++;
+            }
+            if (rtb_share.entry >= RoutingTB_GetLastEntry())
+            {
+                rtb_share.frame_index |= RTB_FRAME_LAST;
+            }
+            memcpy(&frame_msg->data[RTB_FRAME_HEADER_SIZE - sizeof(uint16_t)], &rtb_share.frame_index, sizeof(uint16_t));
+            rtb_share.frame_ready = true;
+            rtb_share.start_date  = Luos_GetSystick();
+        }
+        if (Luos_SendMsg(rtb_share.container, frame_msg) == FAILED)
+        {
+            // No more memory space available, try again later.
+            LUOS_ASSERT((Luos_GetSystick() - rtb_share.start_date) < RTB_SHARE_TIMEOUT_MS);
+            Luos_TimerStart(rtb_share.container, &rtb_share.timer, RTB_SHARE_RETRY_MS, 0, RoutingTB_ShareRetry);
+            return;
+        }
+        rtb_share.frame_ready = false;
+        if (rtb_share.frame_index & RTB_FRAME_LAST)
+        {
+            // The whole routing_table have been sent
+            rtb_share.container = 0;
+            return;
+        }
+        rtb_share.frame_index++;
+        frame_msg->header.size = RTB_FRAME_HEADER_SIZE;
+        RoutingTB_ResetCodec(&rtb_share.codec);
+    }
+}
+/******************************************************************************
+ * @brief try again to send the routing_table frames
+ * @param container sharing the routing_table
+ * @param timer expired
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_ShareRetry(container_t *container, luos_timer_t *timer)
+{
+    uint16_t epoch = 0;
+    (void)timer;
+    memcpy(&epoch, &rtb_share.msg.data[sizeof(uint32_t)], sizeof(uint16_t));
+    if (epoch != rtb_epoch)
+    {
+        // The routing_table changed since the share started, share it again from the start.
+        RoutingTB_Share(container);
+        return;
+    }
+    RoutingTB_ShareFrames();
+}
+
+/******************************************************************************
+ * @brief Detect all containers and create a route table with it.
+ * If multiple containers have the same name it will be changed with a number in it
+ * Automatically at the end this function create a list of sensors id
+ * This function run Luos_Loop until the routing_table is generated and shared,
+ * see RoutingTB_StartDetection to keep running other things meanwhile.
+ * @param container who send
+ * @return None
+ ******************************************************************************/
+void RoutingTB_DetectContainers(container_t *container)
+{
+    RoutingTB_StartDetection(container);
+    while (RoutingTB_DetectionComplete() == FAILED)
+    {
+        Luos_Loop();
+    }
+}
+/******************************************************************************
+ * @brief Start to detect all containers and create a route table with it.
+ * The routing_table is generated and shared from Luos_Loop, RoutingTB_DetectionComplete
+ * tells when it's done.
+ * @param container who send
+ * @return None
+ ******************************************************************************/
+void RoutingTB_StartDetection(container_t *container)
+{
+    // Starts the topology detection.
+    uint16_t nb_node = Robus_TopologyDetection(container->ll_container);
+    // clear the routing table.
+    RoutingTB_Erase();
+    // Generate the routing_table
+    RoutingTB_Generate(container, nb_node);
+}
+/******************************************************************************
+ * @brief Check if the routing_table detection started by RoutingTB_StartDetection is over
+ * @param None
+ * @return SUCCEED if no generation or share is running
+ ******************************************************************************/
+error_return_t RoutingTB_DetectionComplete(void)
+{
+    if ((rtb_generation.container != 0) || (rtb_share.container != 0))
+    {
+        return FAILED;
+    }
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief entry in routable node with associate container
+ * @param route table
+ * @param node structure
+ * @return None
+ ******************************************************************************/
+void RoutingTB_ConvertNodeToRoutingTable(routing_table_t *entry, node_t *node)
+{
+    // Check if the NBR_PORT config is too high to fit into routing table.
+    LUOS_ASSERT(sizeof(node_t) <= (sizeof(routing_table_t) - 1));
+    memset(entry, 0, sizeof(routing_table_t));
+    entry->mode = NODE;
+    memcpy(entry->unmap_data, node->unmap, sizeof(node_t));
+}
+/******************************************************************************
+ * @brief entry in routable container associate to a node
+ * @param route table
+ * @param container in node
+ * @return None
+ ******************************************************************************/
+void RoutingTB_ConvertContainerToRoutingTable(routing_table_t *entry, container_t *container)
+{
+    entry->type = container->ll_container->type;
+    entry->id   = container->ll_container->id;
+    entry->mode = CONTAINER;
+    for (uint8_t i = 0; i < MAX_ALIAS_SIZE; i++)
+    {
+        entry->alias[i] = container->alias[i];
+    }
+}
+/******************************************************************************
+ * @brief convert a routing_table node into an exchange entry
+ * @param node_index index of the node
+ * @param entry to fill
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_NodeToEntry(uint16_t node_index, routing_table_t *entry)
+{
+    memset(entry, 0, sizeof(routing_table_t));
+    entry->mode      = NODE;
+    entry->node_id   = rtb_nodes[node_index].node_id;
+    entry->certified = rtb_nodes[node_index].certified;
+    for (uint16_t i = 0; (i < MAX_RTB_NODE_PORT) && (i < (sizeof(entry->port_table) / sizeof(uint16_t))); i++)
+    {
+        entry->port_table[i] = rtb_nodes[node_index].port_table[i];
+    }
+}
+/******************************************************************************
+ * @brief convert a routing_table container into an exchange entry
+ * @param container_index index of the container
+ * @param entry to fill
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_ContainerToEntry(uint16_t container_index, routing_table_t *entry)
+{
+    memset(entry, 0, sizeof(routing_table_t));
+    entry->mode = CONTAINER;
+    entry->id   = rtb_containers[container_index].id;
+    entry->type = rtb_containers[container_index].type;
+    RoutingTB_BuildAlias(&rtb_containers[container_index], entry->alias);
+}
+/******************************************************************************
+ * @brief add a node at the end of the routing_table
+ * @param node_id of the node
+ * @param certified state of the node
+ * @param port_table of the node
+ * @param port_nb number of ports into port_table
+ * @return Error if the routing_table is full
+ ******************************************************************************/
+static error_return_t RoutingTB_AddNode(uint16_t node_id, uint8_t certified, const uint16_t *port_table, uint16_t port_nb)
+{
+    if (rtb_node_nb >= MAX_RTB_NODE)
+    {
+        return FAILED;
+    }
+    rtb_node_t *node = &rtb_nodes[rtb_node_nb];
+    memset(node, 0, sizeof(rtb_node_t));
+    node->node_id   = node_id;
+    node->certified = certified;
+    for (uint16_t i = 0; (i < MAX_RTB_NODE_PORT) && (i < port_nb); i++)
+    {
+        node->port_table[i] = port_table[i];
+    }
+    node->first_container = rtb_container_nb;
+    rtb_node_nb++;
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief add a container at the end of the routing_table
+ * The container is added to the last added node.
+ * @param id of the container
+ * @param type of the container
+ * @param alias base of the container
+ * @param alias_suffix number to add at the end of the alias base (0 for none)
+ * @return Error if the routing_table is full or if the alias pool is full (the container is added without alias)
+ ******************************************************************************/
+static error_return_t RoutingTB_AddContainer(uint16_t id, uint16_t type, const char *alias, uint16_t alias_suffix)
+{
+    if ((rtb_container_nb >= MAX_RTB_CONTAINER) || (rtb_node_nb == 0))
+    {
+        return FAILED;
+    }
+    uint16_t alias_position                       = RoutingTB_InternAlias(alias);
+    rtb_containers[rtb_container_nb].id           = id;
+    rtb_containers[rtb_container_nb].type         = type;
+    rtb_containers[rtb_container_nb].alias        = alias_position;
+    rtb_containers[rtb_container_nb].alias_suffix = alias_suffix;
+    rtb_container_nb++;
+    return (alias_position == 0xFFFF) ? FAILED : SUCCEED;
+}
+/******************************************************************************
+ * @brief add an entry at the end of the routing_table
+ * Containers entries are added to the last added node.
+ * @param entry to add
+ * @return Error if the routing_table is full
+ ******************************************************************************/
+error_return_t RoutingTB_AddEntry(const routing_table_t *entry)
+{
+    if (entry->mode == NODE)
+    {
+        uint16_t port_table[sizeof(entry->port_table) / sizeof(uint16_t)];
+        memcpy(port_table, (const void *)entry->port_table, sizeof(port_table));
+        return RoutingTB_AddNode(entry->node_id, entry->certified, port_table, sizeof(port_table) / sizeof(uint16_t));
+    }
+    if (entry->mode == CONTAINER)
+    {
+        char alias[MAX_ALIAS_SIZE] = {0};
+        memcpy(alias, entry->alias, ALIAS_SIZE);
+        return RoutingTB_AddContainer(entry->id, entry->type, alias, 0);
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief receive a routing_table message chunk and add its entries
+ * Entries can be splitted between messages, the partial entry is kept until the next chunk.
+ * @param msg chunk received
+ * @return SUCCEED when the routing_table reception is complete
+ ******************************************************************************/
+error_return_t RoutingTB_ReceiveEntries(msg_t *msg)
+{
+    uint16_t skip = 0;
+    if (rtb_rx_remaining_size != msg->header.size)
+    {
+        // This is a new reception or we missed a part of the previous one, reset the session.
+        // The remaining size allow to find the next entry start.
+        rtb_rx_entry_size = 0;
+        skip              = msg->header.size % sizeof(routing_table_t);
+    }
+    // Get chunk size
+    uint16_t chunk_size = msg->header.size;
+    if (chunk_size > MAX_DATA_MSG_SIZE)
+    {
+        chunk_size = MAX_DATA_MSG_SIZE;
+    }
+    for (uint16_t i = skip; i < chunk_size; i++)
+    {
+        ((uint8_t *)&rtb_rx_entry)[rtb_rx_entry_size++] = msg->data[i];
+        if (rtb_rx_entry_size == sizeof(routing_table_t))
+        {
+            // Entries overflowing the routing_table are dropped.
+            RoutingTB_AddEntry(&rtb_rx_entry);
+            rtb_rx_entry_size = 0;
+        }
+    }
+    rtb_rx_remaining_size = msg->header.size - chunk_size;
+    if (rtb_rx_remaining_size == 0)
+    {
+        // route table section reception complete
+        RoutingTB_ComputeRoutingTableEntryNB();
+        if (rtb_generation.container != 0)
+        {
+            // This is an introduction reply, ask the next node
+            Luos_TimerStop(&rtb_generation.timer);
+            RoutingTB_AskIntroduction();
+        }
+        return SUCCEED;
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief decode the records of a routing_table frame and add them
+ * @param msg frame received
+ * @return Error if the frame is malformed
+ ******************************************************************************/
+static error_return_t RoutingTB_DecodeFrame(msg_t *msg)
+{
+    rtb_codec_t codec;
+    uint16_t position = RTB_FRAME_HEADER_SIZE;
+    RoutingTB_ResetCodec(&codec);
+    while (position < msg->header.size)
+    {
+        uint8_t tag = msg->data[position++];
+        if ((tag & RTB_RECORD_KIND_MASK) == RTB_RECORD_NODE)
+        {
+            uint16_t port_table[MAX_RTB_NODE_PORT] = {0};
+            uint16_t node_id                       = 0;
+            uint16_t port                          = 0;
+            if (RoutingTB_ReadVarint(msg, &position, &node_id) == FAILED)
+            {
+                return FAILED;
+            }
+            for (uint8_t i = 0; i < (tag >> RTB_NODE_PORT_SHIFT); i++)
+            {
+                if (RoutingTB_ReadVarint(msg, &position, &port) == FAILED)
+                {
+                    return FAILED;
+                }
+                if (i < MAX_RTB_NODE_PORT)
+                {
+                    port_table[i] = port;
+                }
+            }
+            // Records overflowing the routing_table are dropped.
+            RoutingTB_AddNode(node_id, (tag & RTB_NODE_CERTIFIED) != 0, port_table, MAX_RTB_NODE_PORT);
+        }
+        else if ((tag & RTB_RECORD_KIND_MASK) == RTB_RECORD_CONTAINER)
+        {
+            uint16_t id           = codec.id + 1;
+            uint16_t type         = codec.type;
+            uint16_t alias_suffix = 0;
+            if (((tag & RTB_CONTAINER_NEXT_ID) == 0) && (RoutingTB_ReadVarint(msg, &position, &id) == FAILED))
+            {
+                return FAILED;
+            }
+            if (((tag & RTB_CONTAINER_SAME_TYPE) == 0) && (RoutingTB_ReadVarint(msg, &position, &type) == FAILED))
+            {
+                return FAILED;
+            }
+            if (position >= msg->header.size)
+            {
+                return FAILED;
+            }
+            uint8_t shared = msg->data[position] >> 4;
+            uint8_t length = msg->data[position++] & 0x0F;
+            if (((shared + length) > ALIAS_SIZE) || ((position + length) > msg->header.size))
+            {
+                return FAILED;
+            }
+            memset(&codec.alias[shared], 0, MAX_ALIAS_SIZE - shared);
+            memcpy(&codec.alias[shared], &msg->data[position], length);
+            position += length;
+            if (((tag & RTB_CONTAINER_SUFFIX) != 0) && (RoutingTB_ReadVarint(msg, &position, &alias_suffix) == FAILED))
+            {
+                return FAILED;
+            }
+            // Records overflowing the routing_table are dropped.
+            RoutingTB_AddContainer(id, type, codec.alias, alias_suffix);
+            codec.id   = id;
+            codec.type = type;
+        }
+        else
+        {
+            return FAILED;
+        }
+    }
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief receive a compact routing_table frame
+ * A new routing_table replace the actual one except if it have the same content hash.
+ * @param msg frame received
+ * @return SUCCEED when the routing_table reception is complete
+ ******************************************************************************/
+error_return_t RoutingTB_ReceiveFrame(msg_t *msg)
+{
+    uint32_t hash  = 0;
+    uint16_t epoch = 0;
+    uint16_t frame = 0;
+    if ((msg->header.size < RTB_FRAME_HEADER_SIZE) || (msg->header.size > MAX_DATA_MSG_SIZE))
+    {
+        return FAILED;
+    }
+    memcpy(&hash, &msg->data[0], sizeof(uint32_t));
+    memcpy(&epoch, &msg->data[sizeof(uint32_t)], sizeof(uint16_t));
+    memcpy(&frame, &msg->data[RTB_FRAME_HEADER_SIZE - sizeof(uint16_t)], sizeof(uint16_t));
+    if ((frame & ~RTB_FRAME_LAST) == 0)
+    {
+        // This is the begining of a routing_table
+        if ((hash == rtb_hash) && (rtb_node_nb != 0))
+        {
+            // We already have this routing_table, ignore it but follow its epoch.
+            if (epoch != rtb_epoch)
+            {
+                RoutingTB_SetEpoch(epoch);
+            }
+            rtb_rx_frame = 0xFFFF;
+            return FAILED;
+        }
+        RoutingTB_Erase();
+        rtb_rx_hash  = hash;
+        rtb_rx_frame = 0;
+    }
+    if ((hash != rtb_rx_hash) || ((frame & ~RTB_FRAME_LAST) != rtb_rx_frame))
+    {
+        // This is not the frame we are waiting for, we probably missed one. Drop the reception.
+        rtb_rx_frame = 0xFFFF;
+        return FAILED;
+    }
+    if (RoutingTB_DecodeFrame(msg) == FAILED)
+    {
+        rtb_rx_frame = 0xFFFF;
+        return FAILED;
+    }
+    rtb_rx_frame++;
+    if (frame & RTB_FRAME_LAST)
+    {
+        // route table reception complete
+        rtb_hash     = hash;
+        rtb_rx_frame = 0xFFFF;
+        RoutingTB_SetEpoch(epoch);
+        RoutingTB_ComputeRoutingTableEntryNB();
+        return SUCCEED;
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief get a routing_table entry
+ * Entries are ordered like the exchange format : each node followed by its containers.
+ * @param index of the entry
+ * @param entry to fill
+ * @return Error if the index is out of the routing_table
+ ******************************************************************************/
+error_return_t RoutingTB_GetEntry(uint16_t index, routing_table_t *entry)
+{
+    for (uint16_t node = 0; node < rtb_node_nb; node++)
+    {
+        if (index == 0)
+        {
+            RoutingTB_NodeToEntry(node, entry);
+            return SUCCEED;
+        }
+        index--;
+        uint16_t nb = RoutingTB_NodeContainerEnd(node) - rtb_nodes[node].first_container;
+        if (index < nb)
+        {
+            RoutingTB_ContainerToEntry(rtb_nodes[node].first_container + index, entry);
+            return SUCCEED;
+        }
+        index -= nb;
+    }
+    memset(entry, 0, sizeof(routing_table_t));
+    return FAILED;
+}
+/******************************************************************************
+ * @brief remove containers from the routing_table
+ * @param container_index index of the first container to remove
+ * @param nb number of containers to remove
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_RemoveContainers(uint16_t container_index, uint16_t nb)
+{
+    memmove(&rtb_containers[container_index], &rtb_containers[container_index + nb], sizeof(rtb_container_t) * (rtb_container_nb - (container_index + nb)));
+    rtb_container_nb -= nb;
+    memset(&rtb_containers[rtb_container_nb], 0, sizeof(rtb_container_t) * nb);
+    for (uint16_t i = 0; i < rtb_node_nb; i++)
+    {
+        if (rtb_nodes[i].first_container > container_index)
+        {
+            rtb_nodes[i].first_container -= nb;
+        }
+    }
+    RoutingTB_ComputeSearchLists();
+}
+/******************************************************************************
+ * @brief remove an entire node
+ * @param route table
+ * @return None
+ ******************************************************************************/
+void RoutingTB_RemoveNode(uint16_t nodeid)
+{
+    // instead of removing a node just remove all the container in it to make it unusable
+    // We could add a param (CONTROL for example) to declare the node as STOP
+    // find the node
+    for (uint16_t i = 0; i < rtb_node_nb; i++)
+    {
+        if (rtb_nodes[i].node_id == nodeid)
+        {
+            // We find our node remove all containers
+            uint16_t nb = RoutingTB_NodeContainerEnd(i) - rtb_nodes[i].first_container;
+            if (nb == 0)
+            {
+                // Each container of the node handle the same ASSERT, the node is already removed.
+                return;
+            }
+            RoutingTB_RemoveContainers(rtb_nodes[i].first_container, nb);
+            // All nodes receive the same ASSERT and apply the same modification, so they stay on the same epoch.
+            RoutingTB_SetEpoch(rtb_epoch + 1);
+            rtb_hash = RoutingTB_ComputeHash();
+            return;
+        }
+    }
+}
+/******************************************************************************
+ * @brief remove an entry from routing_table
+ * Only containers entries can be removed.
+ * @param index of the entry (see RoutingTB_GetEntry)
+ * @return None
+ ******************************************************************************/
+void RoutingTB_RemoveOnRoutingTable(uint16_t index)
+{
+    LUOS_ASSERT(index < RoutingTB_GetLastEntry());
+    for (uint16_t node = 0; node < rtb_node_nb; node++)
+    {
+        LUOS_ASSERT(index != 0);
+        index--;
+        uint16_t nb = RoutingTB_NodeContainerEnd(node) - rtb_nodes[node].first_container;
+        if (index < nb)
+        {
+            RoutingTB_RemoveContainers(rtb_nodes[node].first_container + index, 1);
+            return;
+        }
+        index -= nb;
+    }
+}
+/******************************************************************************
+ * @brief eras erouting_table
+ * @param None
+ * @return None
+ ******************************************************************************/
+void RoutingTB_Erase(void)
+{
+    memset(rtb_nodes, 0, sizeof(rtb_nodes));
+    memset(rtb_containers, 0, sizeof(rtb_containers));
+    memset(rtb_alias_hash, 0, sizeof(rtb_alias_hash));
+    rtb_node_nb           = 0;
+    rtb_container_nb      = 0;
+    rtb_alias_pool_size   = 0;
+    rtb_rx_entry_size     = 0;
+    rtb_rx_remaining_size = 0;
+    rtb_rx_frame          = 0xFFFF;
+    rtb_hash              = 0;
+    last_container        = 0;
+    RoutingTB_ComputeSearchLists();
+}
+/******************************************************************************
+ * @brief return the last ID registered into the routing_table
+ * @param None
+ * @return last container ID
+ ******************************************************************************/
+uint16_t RoutingTB_GetLastContainer(void)
+{
+    return (uint16_t)last_container;
+}
+/******************************************************************************
+ * @brief return the number of entries into the routing_table
+ * @param None
+ * @return Last entry
+ ******************************************************************************/
+uint16_t RoutingTB_GetLastEntry(void)
+{
+    return (uint16_t)(rtb_node_nb + rtb_container_nb);
+}
+/******************************************************************************
+ * @brief return the number of containers having no alias because the alias pool is full
+ * Increase RTB_ALIAS_POOL_SIZE if this is not 0.
+ * @param None
+ * @return number of containers without alias
+ ******************************************************************************/
+uint16_t RoutingTB_GetMissingAliasNB(void)
+{
+    uint16_t nb = 0;
+    for (uint16_t i = 0; i < rtb_container_nb; i++)
+    {
+        if (rtb_containers[i].alias == 0xFFFF)
+        {
+            nb++;
+        }
+    }
+    return nb;
+}
+/******************************************************************************
+ * @brief get a copy of the routing_table in the exchange format
+ * Deprecated, use RoutingTB_GetEntry to read the routing_table and RoutingTB_AddEntry to fill it.
+ * The copy is refreshed on each call and modifying it doesn't change the routing_table.
+ * @param None
+ * @return routing_table copy of RoutingTB_GetLastEntry entries
+ ******************************************************************************/
+routing_table_t *RoutingTB_Get(void)
+{
+    // Linkers removing unused sections drop this copy with the function
+    static routing_table_t routing_table[MAX_RTB_NODE + MAX_RTB_CONTAINER];
+    for (uint16_t index = 0; index < (MAX_RTB_NODE + MAX_RTB_CONTAINER); index++)
+    {
+        RoutingTB_GetEntry(index, &routing_table[index]);
+    }
+    return routing_table;
+}
+
+// ********************* routing_table deltas ************************
+
+/******************************************************************************
+ * @brief change the routing_table epoch
+ * @param epoch new epoch
+ * @return None
+ ******************************************************************************/
+static void RoutingTB_SetEpoch(uint16_t epoch)
+{
+    rtb_epoch    = epoch;
+    rtb_reshared = false;
+}
+/******************************************************************************
+ * @brief get the routing_table epoch
+ * The epoch is the same on all nodes sharing the same routing_table.
+ * @param None
+ * @return epoch
+ ******************************************************************************/
+uint16_t RoutingTB_GetEpoch(void)
+{
+    return rtb_epoch;
+}
+/******************************************************************************
+ * @brief write an alias into a delta
+ * @param data to fill
+ * @param alias to write
+ * @return size written
+ ******************************************************************************/
+static uint8_t RoutingTB_WriteAlias(uint8_t *data, const char *alias)
+{
+    uint8_t size = 0;
+    while ((size < ALIAS_SIZE) && (alias[size] != '\0'))
+    {
+        size++;
+    }
+    data[0] = size;
+    memcpy(&data[1], alias, size);
+    return size + 1;
+}
+/******************************************************************************
+ * @brief read an alias from a delta
+ * @param msg delta to read
+ * @param position of the alias, updated to the next data
+ * @param alias string of MAX_ALIAS_SIZE to fill
+ * @return Error if the alias is out of the delta
+ ******************************************************************************/
+static error_return_t RoutingTB_ReadAlias(const msg_t *msg, uint16_t *position, char *alias)
+{
+    if (*position >= msg->header.size)
+    {
+        return FAILED;
+    }
+    uint8_t size = msg->data[(*position)++];
+    if ((size > ALIAS_SIZE) || ((*position + size) > msg->header.size))
+    {
+        return FAILED;
+    }
+    memset(alias, 0, MAX_ALIAS_SIZE);
+    memcpy(alias, &msg->data[*position], size);
+    *position += size;
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief insert a container at the end of the containers of a node
+ * @param node_id of the node
+ * @param id of the container
+ * @param type of the container
+ * @param alias base of the container
+ * @return Error if the node is not found, the routing_table is full or the alias pool is full
+ ******************************************************************************/
+static error_return_t RoutingTB_InsertContainer(uint16_t node_id, uint16_t id, uint16_t type, const char *alias)
+{
+    if (rtb_container_nb >= MAX_RTB_CONTAINER)
+    {
+        return FAILED;
+    }
+    for (uint16_t node = 0; node < rtb_node_nb; node++)
+    {
+        if (rtb_nodes[node].node_id == node_id)
+        {
+            // Intern before moving the containers, a compaction only update the counted ones.
+            uint16_t alias_position = RoutingTB_InternAlias(alias);
+            if (alias_position == 0xFFFF)
+            {
+                return FAILED;
+            }
+            uint16_t index = RoutingTB_NodeContainerEnd(node);
+            memmove(&rtb_containers[index + 1], &rtb_containers[index], sizeof(rtb_container_t) * (rtb_container_nb - index));
+            rtb_containers[index].id           = id;
+            rtb_containers[index].type         = type;
+            rtb_containers[index].alias        = alias_position;
+            rtb_containers[index].alias_suffix = 0;
+            rtb_container_nb++;
+            for (uint16_t i = node + 1; i < rtb_node_nb; i++)
+            {
+                rtb_nodes[i].first_container++;
+            }
+            RoutingTB_ComputeRoutingTableEntryNB();
+            return SUCCEED;
+        }
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief apply a delta on the routing_table
+ * @param msg delta to apply
+ * @return Error if the delta can't be applied
+ ******************************************************************************/
+static error_return_t RoutingTB_ApplyDelta(msg_t *msg)
+{
+    char alias[MAX_ALIAS_SIZE];
+    uint16_t position = RTB_DELTA_HEADER_SIZE;
+    uint16_t id       = 0;
+    uint16_t node_id  = 0;
+    uint16_t type     = 0;
+    uint16_t index    = 0;
+    uint8_t operation = 0;
+    if (position >= msg->header.size)
+    {
+        return FAILED;
+    }
+    operation = msg->data[position++];
+    if (RoutingTB_ReadVarint(msg, &position, &id) == FAILED)
+    {
+        return FAILED;
+    }
+    index = RoutingTB_ContainerIndexFromID(id);
+    switch (operation)
+    {
+        case RTB_DELTA_ADD:
+            if ((RoutingTB_ReadVarint(msg, &position, &node_id) == FAILED)
+                || (RoutingTB_ReadVarint(msg, &position, &type) == FAILED)
+                || (RoutingTB_ReadAlias(msg, &position, alias) == FAILED)
+                || (index < rtb_container_nb))
+            {
+                return FAILED;
+            }
+            return RoutingTB_InsertContainer(node_id, id, type, alias);
+            break;
+        case RTB_DELTA_REMOVE:
+            if (index >= rtb_container_nb)
+            {
+                return FAILED;
+            }
+            RoutingTB_RemoveContainers(index, 1);
+            return SUCCEED;
+            break;
+        case RTB_DELTA_RENAME:
+            if ((RoutingTB_ReadAlias(msg, &position, alias) == FAILED) || (index >= rtb_container_nb))
+            {
+                return FAILED;
+            }
+            {
+                // Release the previous alias base so a compaction can remove it
+                char previous_alias[MAX_ALIAS_SIZE] = {0};
+                bool had_alias                      = (rtb_containers[index].alias != 0xFFFF);
+                if (had_alias)
+                {
+                    strncpy(previous_alias, &rtb_alias_pool[rtb_containers[index].alias], ALIAS_SIZE);
+                }
+                rtb_containers[index].alias = 0xFFFF;
+                uint16_t alias_position     = RoutingTB_InternAlias(alias);
+                if (alias_position == 0xFFFF)
+                {
+                    // The previous alias base fit into the memory it just released
+                    if (had_alias)
+                    {
+                        rtb_containers[index].alias = RoutingTB_InternAlias(previous_alias);
+                    }
+                    return FAILED;
+                }
+                rtb_containers[index].alias        = alias_position;
+                rtb_containers[index].alias_suffix = 0;
+            }
+            RoutingTB_ComputeSearchLists();
+            return SUCCEED;
+            break;
+        default:
+            break;
+    }
+    return FAILED;
+}
+/******************************************************************************
+ * @brief apply a delta locally and broadcast it to all nodes
+ * @param container who send
+ * @param msg delta to send
+ * @return Error if the delta can't be applied
+ ******************************************************************************/
+static error_return_t RoutingTB_SendDelta(container_t *container, msg_t *msg)
+{
+    if (RoutingTB_ApplyDelta(msg) == FAILED)
+    {
+        return FAILED;
+    }
+    RoutingTB_SetEpoch(rtb_epoch + 1);
+    rtb_hash = RoutingTB_ComputeHash();
+    memcpy(&msg->data[0], &rtb_epoch, sizeof(uint16_t));
+    memcpy(&msg->data[sizeof(uint16_t)], &rtb_hash, sizeof(uint32_t));
+    msg->header.cmd         = RTB_DELTA;
+    msg->header.target_mode = BROADCAST;
+    msg->header.target      = BROADCAST_VAL;
+    RoutingTB_Send(container, msg);
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief add a container to a node on all routing tables
+ * @param container who send
+ * @param node_id of the node hosting the new container
+ * @param id of the new container
+ * @param type of the new container
+ * @param alias of the new container
+ * @return Error if the container can't be added
+ ******************************************************************************/
+error_return_t RoutingTB_DeltaAdd(container_t *container, uint16_t node_id, uint16_t id, luos_type_t type, char *alias)
+{
+    msg_t delta_msg;
+    uint16_t size          = RTB_DELTA_HEADER_SIZE;
+    delta_msg.data[size++] = RTB_DELTA_ADD;
+    size += RoutingTB_WriteVarint(&delta_msg.data[size], id);
+    size += RoutingTB_WriteVarint(&delta_msg.data[size], node_id);
+    size += RoutingTB_WriteVarint(&delta_msg.data[size], type);
+    size += RoutingTB_WriteAlias(&delta_msg.data[size], alias);
+    delta_msg.header.size = size;
+    return RoutingTB_SendDelta(container, &delta_msg);
+}
+/******************************************************************************
+ * @brief remove a container from all routing tables
+ * @param container who send
+ * @param id of the container to remove
+ * @return Error if the container can't be removed
+ ******************************************************************************/
+error_return_t RoutingTB_DeltaRemove(container_t *container, uint16_t id)
+{
+    msg_t delta_msg;
+    uint16_t size          = RTB_DELTA_HEADER_SIZE;
+    delta_msg.data[size++] = RTB_DELTA_REMOVE;
+    size += RoutingTB_WriteVarint(&delta_msg.data[size], id);
+    delta_msg.header.size = size;
+    return RoutingTB_SendDelta(container, &delta_msg);
+}
+/******************************************************************************
+ * @brief rename a container on all routing tables
+ * @param container who send
+ * @param id of the container to rename
+ * @param alias new alias of the container
+ * @return Error if the container can't be renamed
+ ******************************************************************************/
+error_return_t RoutingTB_DeltaRename(container_t *container, uint16_t id, char *alias)
+{
+    msg_t delta_msg;
+    uint16_t size          = RTB_DELTA_HEADER_SIZE;
+    delta_msg.data[size++] = RTB_DELTA_RENAME;
+    size += RoutingTB_WriteVarint(&delta_msg.data[size], id);
+    size += RoutingTB_WriteAlias(&delta_msg.data[size], alias);
+    delta_msg.header.size = size;
+    return RoutingTB_SendDelta(container, &delta_msg);
+}
+/******************************************************************************
+ * @brief receive a routing_table delta and acknowledge it
+ * The delta is applied only if it follow our epoch.
+ * @param container who receive
+ * @param msg delta received
+ * @return SUCCEED if the delta have been applied
+ ******************************************************************************/
+error_return_t RoutingTB_ReceiveDelta(container_t *container, msg_t *msg)
+{
+    error_return_t result = FAILED;
+    uint16_t epoch        = 0;
+    uint32_t hash         = 0;
+    if ((msg->header.size < RTB_DELTA_HEADER_SIZE) || (msg->header.size > MAX_DATA_MSG_SIZE) || (rtb_node_nb == 0))
+    {
+        return FAILED;
+    }
+    memcpy(&epoch, &msg->data[0], sizeof(uint16_t));
+    memcpy(&hash, &msg->data[sizeof(uint16_t)], sizeof(uint32_t));
+    if ((epoch == rtb_epoch) && (hash == rtb_hash))
+    {
+        // This delta is already applied, this is probably our own one.
+        return SUCCEED;
+    }
+    if ((epoch == (uint16_t)(rtb_epoch + 1)) && (RoutingTB_ApplyDelta(msg) == SUCCEED))
+    {
+        RoutingTB_SetEpoch(epoch);
+        rtb_hash = RoutingTB_ComputeHash();
+        result   = SUCCEED;
+    }
+    // Acknowledge with our epoch, a mismatch will make the sender share the complete routing_table again.
+    msg_t ack_msg;
+    ack_msg.header.cmd         = RTB_EPOCH;
+    ack_msg.header.target_mode = ID;
+    ack_msg.header.target      = msg->header.source;
+    ack_msg.header.size        = sizeof(uint16_t) + sizeof(uint32_t);
+    memcpy(&ack_msg.data[0], &rtb_epoch, sizeof(uint16_t));
+    memcpy(&ack_msg.data[sizeof(uint16_t)], &rtb_hash, sizeof(uint32_t));
+    Luos_SendMsg(container, &ack_msg);
+    return result;
+}
+/******************************************************************************
+ * @brief receive a delta acknowledgement
+ * If a node is not synchronized the complete routing_table is shared again.
+ * @param container who receive
+ * @param msg acknowledgement received
+ * @return None
+ ******************************************************************************/
+void RoutingTB_ReceiveEpoch(container_t *container, msg_t *msg)
+{
+    uint16_t epoch = 0;
+    uint32_t hash  = 0;
+    if (msg->header.size != (sizeof(uint16_t) + sizeof(uint32_t)))
+    {
+        return;
+    }
+    memcpy(&epoch, &msg->data[0], sizeof(uint16_t));
+    memcpy(&hash, &msg->data[sizeof(uint16_t)], sizeof(uint32_t));
+    if (((epoch != rtb_epoch) || (hash != rtb_hash)) && (rtb_reshared == false))
+    {
+        // Only share once by epoch, nodes already synchronized will ignore it.
+        rtb_reshared = true;
+        RoutingTB_Share(container);
+    }
+}
+/******************************************************************************
+ * @brief Return an id from alias using a cache
+ * The alias is searched again only if the routing_table changed since the last call.
+ * @param cache of the id (initialized to 0)
+ * @param pointer to alias
+ * @return ID or Error
+ ******************************************************************************/
+uint16_t RoutingTB_IDFromAliasCached(rtb_id_cache_t *cache, char *alias)
+{
+    if (cache->version != rtb_version)
+    {
+        cache->id      = RoutingTB_IDFromAlias(alias);
+        cache->version = rtb_version;
+    }
+    return cache->id;
 }
@@ -5,6 +5,8 @@
  * @version 0.0.0
  ******************************************************************************/
 #include <string.h>
+#include <stdbool.h>
+#include <math.h>
 #include "streaming.h"
 #include "luos_utils.h"
 /*******************************************************************************
@@ -22,22 +24,45 @@
 /******************************************************************************
  * @brief Initialisation of a streaming channel.
  * @param ring_buffer Pointer to a data table
- * @param ring_buffer_size size of the buffer in number of values.
+ * @param ring_buffer_size size of the buffer in number of values, must be a power of 2.
  * @param data_size values size.
  * @return streaming channel
  ******************************************************************************/
 streaming_channel_t Stream_CreateStreamingChannel(const void *ring_buffer, uint16_t ring_buffer_size, uint8_t data_size)
 {
     streaming_channel_t stream;
-    LUOS_ASSERT((ring_buffer != NULL) || (ring_buffer_size > 0) || (data_size > 0));
+    LUOS_ASSERT((ring_buffer != NULL) && (ring_buffer_size > 0) && (data_size > 0));
+    // The ring buffer size have to be a power of 2 to be masked
+    LUOS_ASSERT((ring_buffer_size & (ring_buffer_size - 1)) == 0);
     // Save ring buffer informations
-    stream.ring_buffer     = (void *)ring_buffer;
-    stream.data_size       = data_size;
-    stream.end_ring_buffer = (void *)ring_buffer + (stream.data_size * ring_buffer_size);
+    stream.ring_buffer = (void *)ring_buffer;
+    stream.data_size   = data_size;
+    stream.mask        = ring_buffer_size - 1;
 
-    // Set data pointers to 0
-    stream.data_ptr   = stream.ring_buffer;
-    stream.sample_ptr = stream.ring_buffer;
+    // Set sample counters to 0
+    stream.head       = 0;
+    stream.tail       = 0;
+    stream.write_head = 0;
+    stream.broadcast  = false;
+    stream.timing     = NULL;
+    stream.reducer    = NULL;
+    stream.codec      = 0;
+    stream.credit     = NULL;
+    stream.drop_nb    = 0;
+    return stream;
+}
+/******************************************************************************
+ * @brief Initialisation of a broadcast streaming channel.
+ * A broadcast channel is read by any number of stream_reader_t.
+ * @param ring_buffer Pointer to a data table
+ * @param ring_buffer_size size of the buffer in number of values, must be a power of 2.
+ * @param data_size values size.
+ * @return streaming channel
+ ******************************************************************************/
+streaming_channel_t Stream_CreateBroadcastChannel(const void *ring_buffer, uint16_t ring_buffer_size, uint8_t data_size)
+{
+    streaming_channel_t stream = Stream_CreateStreamingChannel(ring_buffer, ring_buffer_size, data_size);
+    stream.broadcast           = true;
     return stream;
 }
 /******************************************************************************
@@ -47,93 +72,919 @@ streaming_channel_t Stream_CreateStreamingChannel(const void *ring_buffer, uint1
  ******************************************************************************/
 void Stream_ResetStreamingChannel(streaming_channel_t *stream)
 {
-    stream->data_ptr   = stream->ring_buffer;
-    stream->sample_ptr = stream->ring_buffer;
+    stream->head       = 0;
+    stream->tail       = 0;
+    stream->write_head = 0;
 }
 /******************************************************************************
- * @brief set data into ring buffer.
+ * @brief describe a region of the ring buffer using at most 2 spans
+ * @param stream streaming channel pointer
+ * @param counter sample counter of the region start
+ * @param size number of samples of the region
+ * @param spans table of 2 spans to fill
+ * @return None
+ ******************************************************************************/
+static void Stream_FillSpans(streaming_channel_t *stream, uint32_t counter, uint32_t size, stream_span_t spans[2])
+{
+    uint32_t position = counter & stream->mask;
+    uint32_t chunk1   = stream->mask + 1 - position;
+    if (chunk1 > size)
+    {
+        chunk1 = size;
+    }
+    spans[0].data = (uint8_t *)stream->ring_buffer + (position * stream->data_size);
+    spans[0].size = (uint16_t)chunk1;
+    spans[1].data = stream->ring_buffer;
+    spans[1].size = (uint16_t)(size - chunk1);
+}
+/******************************************************************************
+ * @brief get the readable samples in place.
+ * Only the consumer can peek spans, samples stay in the ring buffer until Stream_CommitRead.
+ * @param stream streaming channel pointer
+ * @param spans table of 2 spans filled with the readable samples
+ * @return number of readable samples
+ ******************************************************************************/
+uint16_t Stream_PeekSpans(streaming_channel_t *stream, stream_span_t spans[2])
+{
+    // Broadcast channels are read using stream_reader_t
+    LUOS_ASSERT(stream->broadcast == false);
+    uint32_t tail = stream->tail;
+    // Acquire the head to be sure the producer finished to write the samples we will read
+    uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    Stream_FillSpans(stream, tail, head - tail, spans);
+    return (uint16_t)(head - tail);
+}
+/******************************************************************************
+ * @brief give back to the producer samples read in place.
+ * @param stream streaming channel pointer
+ * @param size number of samples consumed
+ * @return None
+ ******************************************************************************/
+void Stream_CommitRead(streaming_channel_t *stream, uint16_t size)
+{
+    uint32_t tail = stream->tail;
+    LUOS_ASSERT((__atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) - tail) >= size);
+    // Release the new tail after the data read to give the space back to the producer
+    __atomic_store_n(&stream->tail, tail + size, __ATOMIC_RELEASE);
+}
+/******************************************************************************
+ * @brief get the writable space in place.
+ * Only the producer can reserve spans, samples are published by Stream_CommitWrite.
+ * @param stream streaming channel pointer
+ * @param spans table of 2 spans filled with the free space
+ * @return number of writable samples
+ ******************************************************************************/
+uint16_t Stream_ReserveSpans(streaming_channel_t *stream, stream_span_t spans[2])
+{
+    // Broadcast channels have to announce the samples they overwrite, use Stream_PutSample
+    LUOS_ASSERT(stream->broadcast == false);
+    uint32_t head = stream->head;
+    // Acquire the tail to be sure the consumer finished to read the space we will write
+    uint32_t free_space = stream->mask + 1 - (head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE));
+    Stream_FillSpans(stream, head, free_space, spans);
+    return (uint16_t)free_space;
+}
+/******************************************************************************
+ * @brief publish samples written in place to the consumer.
+ * @param stream streaming channel pointer
+ * @param size number of samples written
+ * @return None
+ ******************************************************************************/
+void Stream_CommitWrite(streaming_channel_t *stream, uint16_t size)
+{
+    uint32_t head = stream->head;
+    // check if we exceed ring buffer capacity
+    LUOS_ASSERT(stream->broadcast || ((head - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE) + size) <= (stream->mask + 1)));
+    // Release the new head after the data write to publish it to the consumer
+    __atomic_store_n(&stream->head, head + size, __ATOMIC_RELEASE);
+}
+/******************************************************************************
+ * @brief store samples into ring buffer without reduction.
  * @param stream streaming channel pointer
  * @param data a pointer to the data table
  * @param size The number of data to copy
  * @return number of available samples
  ******************************************************************************/
-uint8_t Stream_PutSample(streaming_channel_t *stream, const void *data, uint16_t size)
+static uint16_t Stream_StoreSample(streaming_channel_t *stream, const void *data, uint16_t size)
 {
-    if (((size * stream->data_size) + stream->data_ptr) > stream->end_ring_buffer)
+    stream_span_t spans[2];
+    uint16_t free_space = 0;
+    if (stream->broadcast)
     {
-        // our data exceeds ring buffer end, cut it and copy.
-        uint16_t chunk1 = stream->end_ring_buffer - stream->data_ptr;
-        uint16_t chunk2 = (size * stream->data_size) - chunk1;
-        // check if we exceed ring buffer capacity
-        LUOS_ASSERT(stream->sample_ptr >= (stream->ring_buffer + chunk2));
-        // Everything good copy datas.
-        memcpy(stream->data_ptr, data, chunk1);
-        memcpy(stream->ring_buffer, (char *)data + chunk1, chunk2);
-        // Set the new data pointer
-        stream->data_ptr = stream->ring_buffer + chunk2;
+        // Readers never hold the producer, the oldest samples are overwritten
+        if (size > (stream->mask + 1))
+        {
+            // Only the last samples fit in the ring buffer
+            stream->drop_nb += size - (stream->mask + 1);
+            data = (const uint8_t *)data + ((size - (stream->mask + 1)) * stream->data_size);
+            size = stream->mask + 1;
+        }
+        // Announce the samples we will overwrite to the readers before writing them
+        __atomic_store_n(&stream->write_head, stream->head + size, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        Stream_FillSpans(stream, stream->head, size, spans);
+        // Compute the free space giving the number of samples the ring will contain
+        free_space = ((stream->head + size) < (stream->mask + 1)) ? (stream->mask + 1 - stream->head) : size;
     }
     else
     {
-        // our data fit before ring buffer end
-        // check if we exceed ring buffer capacity
-        LUOS_ASSERT((stream->data_ptr >= stream->sample_ptr) && ((stream->data_ptr + (size * stream->data_size)) <= stream->end_ring_buffer));
-        memcpy(stream->data_ptr, data, (size * stream->data_size));
-        // Set the new data pointer
-        stream->data_ptr = stream->data_ptr + (size * stream->data_size);
+        free_space = Stream_ReserveSpans(stream, spans);
+        if (size > free_space)
+        {
+            // The ring buffer is full, drop the samples exceeding its capacity
+            stream->drop_nb += size - free_space;
+            size = free_space;
+        }
+    }
+    // Copy datas, cutting it if it exceeds ring buffer end
+    uint16_t chunk1 = (spans[0].size > size) ? size : spans[0].size;
+    memcpy(spans[0].data, data, chunk1 * stream->data_size);
+    memcpy(spans[1].data, (const uint8_t *)data + (chunk1 * stream->data_size), (size - chunk1) * stream->data_size);
+    Stream_CommitWrite(stream, size);
+    return (uint16_t)(stream->mask + 1 - free_space + size);
+}
+/******************************************************************************
+ * @brief count the samples stored in the ring buffer, as returned by Stream_PutSample.
+ * @param stream streaming channel pointer
+ * @return number of available samples
+ ******************************************************************************/
+static uint16_t Stream_StoredSampleNB(streaming_channel_t *stream)
+{
+    if (stream->broadcast)
+    {
+        // The ring is full once the producer wrote its size
+        return (stream->head < (stream->mask + 1)) ? (uint16_t)stream->head : (uint16_t)(stream->mask + 1);
     }
     return Stream_GetAvailableSampleNB(stream);
 }
 /******************************************************************************
- * @brief copy a sample from ring buffer to a data.
+ * @brief apply the reduction configuration staged by Stream_SetReduction.
+ * Only called by the producer between two windows.
  * @param stream streaming channel pointer
- * @param data a pointer of data
- * @param size data
  * @return None
  ******************************************************************************/
-uint8_t Stream_GetSample(streaming_channel_t *stream, void *data, uint16_t size)
+static void Stream_ApplyReduction(streaming_channel_t *stream)
+{
+    stream_reducer_t *reducer = stream->reducer;
+    reducer->switch_factor    = reducer->reduction.factor;
+    reducer->switch_head      = stream->head;
+    reducer->reduction        = reducer->next;
+    reducer->count            = 0;
+    reducer->primed           = false;
+    reducer->next_ready       = false;
+    reducer->switched         = true;
+}
+/******************************************************************************
+ * @brief reduce samples and store the result into ring buffer.
+ * @param stream streaming channel pointer
+ * @param data a pointer to the data table
+ * @param size The number of data to reduce
+ * @return number of available samples
+ ******************************************************************************/
+static uint16_t Stream_ReduceSample(streaming_channel_t *stream, const void *data, uint16_t size)
 {
-    uint16_t nb_available_samples = Stream_GetAvailableSampleNB(stream);
-    if (nb_available_samples >= size)
+    stream_reducer_t *reducer = stream->reducer;
+    const uint8_t mode        = reducer->reduction.mode;
+    const uint8_t value_nb    = stream->data_size / sizeof(float);
+    for (uint16_t i = 0; i < size; i++)
     {
-        // check if we need to loop in ring buffer
-        if ((stream->sample_ptr + (size * stream->data_size)) > stream->end_ring_buffer)
+        const uint8_t *sample = (const uint8_t *)data + (i * stream->data_size);
+        if ((reducer->count == 0) && (reducer->next_ready))
+        {
+            // A new configuration is waiting for the end of the window, put the remaining samples with it
+            Stream_ApplyReduction(stream);
+            return Stream_PutSample(stream, sample, size - i);
+        }
+        if (mode == STREAM_DECIMATE)
         {
-            // requested data exceeds ring buffer end, cut it and copy.
-            int chunk1 = stream->end_ring_buffer - stream->sample_ptr;
-            int chunk2 = (size * stream->data_size) - chunk1;
-            memcpy(data, stream->sample_ptr, chunk1);
-            memcpy((char *)data + chunk1, stream->ring_buffer, chunk2);
-            // Set the new sample pointer
-            stream->sample_ptr = stream->ring_buffer + chunk2;
+            // Keep the first sample of each window whatever its type
+            if (reducer->count == 0)
+            {
+                Stream_StoreSample(stream, sample, 1);
+            }
         }
         else
         {
-            data = memcpy(data, stream->sample_ptr, (size * stream->data_size));
-            // Set the new sample pointer
-            stream->sample_ptr = stream->sample_ptr + (size * stream->data_size);
+            float value[MAX_STREAM_VALUES];
+            float *acc = reducer->acc;
+            memcpy(value, sample, stream->data_size);
+            if ((reducer->count == 0) && (mode != STREAM_LOWPASS))
+            {
+                // Start a new window
+                for (uint8_t v = 0; v < value_nb; v++)
+                {
+                    acc[v] = (mode == STREAM_RMS) ? (value[v] * value[v]) : value[v];
+                }
+            }
+            else
+            {
+                switch (mode)
+                {
+                    case STREAM_MIN:
+                        for (uint8_t v = 0; v < value_nb; v++)
+                        {
+                            acc[v] = (value[v] < acc[v]) ? value[v] : acc[v];
+                        }
+                        break;
+                    case STREAM_MAX:
+                        for (uint8_t v = 0; v < value_nb; v++)
+                        {
+                            acc[v] = (value[v] > acc[v]) ? value[v] : acc[v];
+                        }
+                        break;
+                    case STREAM_MEAN:
+                        for (uint8_t v = 0; v < value_nb; v++)
+                        {
+                            acc[v] += value[v];
+                        }
+                        break;
+                    case STREAM_RMS:
+                        for (uint8_t v = 0; v < value_nb; v++)
+                        {
+                            acc[v] += value[v] * value[v];
+                        }
+                        break;
+                    case STREAM_LOWPASS:
+                        if (reducer->primed == false)
+                        {
+                            // Start the filter on the first sample
+                            memcpy(acc, value, stream->data_size);
+                            reducer->primed = true;
+                        }
+                        for (uint8_t v = 0; v < value_nb; v++)
+                        {
+                            acc[v] += reducer->reduction.alpha * (value[v] - acc[v]);
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        reducer->count++;
+        if (reducer->count >= reducer->reduction.factor)
+        {
+            // End of the window, store its result
+            reducer->count = 0;
+            if (mode != STREAM_DECIMATE)
+            {
+                float result[MAX_STREAM_VALUES];
+                for (uint8_t v = 0; v < value_nb; v++)
+                {
+                    result[v] = reducer->acc[v];
+                    if (mode == STREAM_MEAN)
+                    {
+                        result[v] /= reducer->reduction.factor;
+                    }
+                    else if (mode == STREAM_RMS)
+                    {
+                        result[v] = sqrtf(result[v] / reducer->reduction.factor);
+                    }
+                }
+                Stream_StoreSample(stream, result, 1);
+            }
         }
-
-        nb_available_samples -= size;
     }
-    else
+    return Stream_StoredSampleNB(stream);
+}
+/******************************************************************************
+ * @brief set data into ring buffer.
+ * Only one producer can put samples in a streaming channel.
+ * Samples exceeding the ring buffer capacity are dropped and counted in drop_nb.
+ * @param stream streaming channel pointer
+ * @param data a pointer to the data table
+ * @param size The number of data to copy
+ * @return number of available samples
+ ******************************************************************************/
+uint16_t Stream_PutSample(streaming_channel_t *stream, const void *data, uint16_t size)
+{
+    stream_reducer_t *reducer = stream->reducer;
+    if (reducer != NULL)
+    {
+        if ((reducer->count == 0) && (reducer->next_ready))
+        {
+            Stream_ApplyReduction(stream);
+        }
+        if (reducer->reduction.mode != STREAM_RAW)
+        {
+            return Stream_ReduceSample(stream, data, size);
+        }
+    }
+    return Stream_StoreSample(stream, data, size);
+}
+/******************************************************************************
+ * @brief copy a sample from ring buffer to a data.
+ * Only one consumer can get samples from a streaming channel.
+ * @param stream streaming channel pointer
+ * @param data a pointer of data
+ * @param size data
+ * @return number of remaining samples, 0 if there is not enough samples
+ ******************************************************************************/
+uint16_t Stream_GetSample(streaming_channel_t *stream, void *data, uint16_t size)
+{
+    stream_span_t spans[2];
+    uint16_t available = Stream_PeekSpans(stream, spans);
+    if (available < size)
     {
         // no more data
         return 0;
     }
-    return nb_available_samples;
+    // Copy datas, cutting it if it exceeds ring buffer end
+    uint16_t chunk1 = (spans[0].size > size) ? size : spans[0].size;
+    memcpy(data, spans[0].data, chunk1 * stream->data_size);
+    memcpy((uint8_t *)data + (chunk1 * stream->data_size), spans[1].data, (size - chunk1) * stream->data_size);
+    Stream_CommitRead(stream, size);
+    return available - size;
 }
 /******************************************************************************
  * @brief return the number of available samples
  * @param stream streaming channel pointer
  * @return number of available samples
  ******************************************************************************/
-uint8_t Stream_GetAvailableSampleNB(streaming_channel_t *stream)
+uint16_t Stream_GetAvailableSampleNB(streaming_channel_t *stream)
+{
+    // Counters are monotonic, their difference stay right when they wrap
+    return (uint16_t)(__atomic_load_n(&stream->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&stream->tail, __ATOMIC_ACQUIRE));
+}
+/******************************************************************************
+ * @brief skip the samples a reader lost because the producer lapped it
+ * @param reader stream reader pointer
+ * @return None
+ ******************************************************************************/
+static void Stream_ReaderCatchUp(stream_reader_t *reader)
+{
+    uint32_t capacity   = reader->stream->mask + 1;
+    uint32_t write_head = __atomic_load_n(&reader->stream->write_head, __ATOMIC_ACQUIRE);
+    if ((write_head - reader->tail) > capacity)
+    {
+        reader->overrun += write_head - reader->tail - capacity;
+        reader->tail = write_head - capacity;
+    }
+}
+/******************************************************************************
+ * @brief register a new reader on a broadcast channel.
+ * The reader only get samples put after its creation.
+ * @param stream broadcast streaming channel pointer
+ * @return stream reader
+ ******************************************************************************/
+stream_reader_t Stream_CreateReader(streaming_channel_t *stream)
+{
+    stream_reader_t reader;
+    LUOS_ASSERT((stream != NULL) && (stream->broadcast == true));
+    reader.stream  = stream;
+    reader.tail    = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    reader.overrun = 0;
+    return reader;
+}
+/******************************************************************************
+ * @brief copy samples of a broadcast channel to a data.
+ * Each reader can only be used by one consumer.
+ * @param reader stream reader pointer
+ * @param data a pointer of data
+ * @param size data
+ * @return number of remaining samples, 0 if there is not enough samples
+ ******************************************************************************/
+uint16_t Stream_ReaderGetSample(stream_reader_t *reader, void *data, uint16_t size)
+{
+    streaming_channel_t *stream = reader->stream;
+    stream_span_t spans[2];
+    Stream_ReaderCatchUp(reader);
+    // Acquire the head to be sure the producer finished to write the samples we will read
+    uint32_t head = __atomic_load_n(&stream->head, __ATOMIC_ACQUIRE);
+    if ((head - reader->tail) < size)
+    {
+        // no more data
+        return 0;
+    }
+    // Copy datas, cutting it if it exceeds ring buffer end
+    Stream_FillSpans(stream, reader->tail, size, spans);
+    memcpy(data, spans[0].data, spans[0].size * stream->data_size);
+    memcpy((uint8_t *)data + (spans[0].size * stream->data_size), spans[1].data, spans[1].size * stream->data_size);
+    // Check the producer didn't start to overwrite those samples during the copy
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if ((__atomic_load_n(&stream->write_head, __ATOMIC_RELAXED) - reader->tail) > (stream->mask + 1))
+    {
+        // The copy is corrupted, drop it
+        Stream_ReaderCatchUp(reader);
+        return 0;
+    }
+    reader->tail += size;
+    return (uint16_t)(head - reader->tail);
+}
+/******************************************************************************
+ * @brief return the number of samples available for a reader
+ * @param reader stream reader pointer
+ * @return number of available samples
+ ******************************************************************************/
+uint16_t Stream_ReaderGetAvailableSampleNB(stream_reader_t *reader)
+{
+    Stream_ReaderCatchUp(reader);
+    return (uint16_t)(__atomic_load_n(&reader->stream->head, __ATOMIC_ACQUIRE) - reader->tail);
+}
+/******************************************************************************
+ * @brief send the samples of a channel in timestamped frames.
+ * @param stream streaming channel pointer
+ * @param timing frame informations storage
+ * @param date of the next sample put in the channel in us
+ * @param period between two put samples in us
+ * @return None
+ ******************************************************************************/
+void Stream_SetSampling(streaming_channel_t *stream, stream_timing_t *timing, uint32_t date, uint32_t period)
+{
+    LUOS_ASSERT((timing != NULL) && (period > 0));
+    memset(timing, 0, sizeof(stream_timing_t));
+    timing->origin      = stream->head;
+    timing->origin_date = date;
+    timing->period      = period;
+    if (stream->reducer != NULL)
+    {
+        // Stored samples are spaced by the reduction factor, this period already use the last applied one
+        stream->reducer->switched = false;
+        timing->period *= stream->reducer->reduction.factor;
+    }
+    stream->timing = timing;
+}
+/******************************************************************************
+ * @brief restart the dates of the channel from the last reduction change.
+ * Only called by the consumer, the producer applying the reductions.
+ * @param stream streaming channel pointer
+ * @param force true to restart the dates even if older samples are still to send
+ * @return None
+ ******************************************************************************/
+static void Stream_SyncReduction(streaming_channel_t *stream, uint8_t force)
+{
+    stream_reducer_t *reducer = stream->reducer;
+    if ((reducer == NULL) || (reducer->switched == false))
+    {
+        return;
+    }
+    if ((force == false) && ((int32_t)(stream->tail - reducer->switch_head) < 0))
+    {
+        // Samples stored before the change keep the previous period
+        return;
+    }
+    if (stream->timing != NULL)
+    {
+        // Samples stored from switch_head are spaced by the new factor
+        stream_timing_t *timing = stream->timing;
+        timing->origin_date += (reducer->switch_head - timing->origin) * timing->period;
+        timing->origin = reducer->switch_head;
+        timing->period = (timing->period / reducer->switch_factor) * reducer->reduction.factor;
+    }
+    reducer->switched = false;
+}
+/******************************************************************************
+ * @brief receive timestamped frames into a channel.
+ * Resampling is only available for samples made of float values.
+ * @param stream streaming channel pointer
+ * @param timing frame informations storage
+ * @param period of the resampled samples in us, 0 to store samples as received
+ * @return None
+ ******************************************************************************/
+void Stream_SetResampling(streaming_channel_t *stream, stream_timing_t *timing, uint32_t period)
+{
+    LUOS_ASSERT(timing != NULL);
+    LUOS_ASSERT((period == 0) || (((stream->data_size % sizeof(float)) == 0) && ((stream->data_size / sizeof(float)) <= MAX_STREAM_VALUES)));
+    memset(timing, 0, sizeof(stream_timing_t));
+    timing->period = period;
+    stream->timing = timing;
+}
+/******************************************************************************
+ * @brief fill the frame header of the next samples to send.
+ * @param stream streaming channel pointer
+ * @param frame header to fill
+ * @return None
+ ******************************************************************************/
+void Stream_MakeFrame(streaming_channel_t *stream, stream_frame_t *frame)
+{
+    stream_timing_t *timing = stream->timing;
+    Stream_SyncReduction(stream, false);
+    frame->seq = timing->seq++;
+    // The date of the first sample is computed from the origin sample
+    frame->timestamp = timing->origin_date + (stream->tail - timing->origin) * timing->period;
+    frame->period    = timing->period;
+}
+/******************************************************************************
+ * @brief count the frames lost before a received frame
+ * @param stream streaming channel pointer
+ * @param frame header of the received samples
+ * @return None
+ ******************************************************************************/
+static void Stream_CheckFrame(streaming_channel_t *stream, const stream_frame_t *frame)
+{
+    stream_timing_t *timing = stream->timing;
+    if (timing->receiving && (frame->seq != timing->seq))
+    {
+        timing->lost_frame += (uint8_t)(frame->seq - timing->seq);
+    }
+    timing->seq          = frame->seq + 1;
+    timing->frame_period = frame->period;
+}
+/******************************************************************************
+ * @brief linearly resample a received sample to the local period
+ * @param stream streaming channel pointer
+ * @param date of the received sample in us
+ * @param sample a pointer to the received sample
+ * @return None
+ ******************************************************************************/
+static void Stream_ResampleSample(streaming_channel_t *stream, uint32_t date, const void *sample)
 {
-    uint16_t nb_available_sample = (stream->data_ptr - stream->sample_ptr) / stream->data_size;
-    if (nb_available_sample < 0)
+    stream_timing_t *timing = stream->timing;
+    uint8_t value_nb        = stream->data_size / sizeof(float);
+    float value[MAX_STREAM_VALUES];
+    float resampled[MAX_STREAM_VALUES];
+    memcpy(value, sample, stream->data_size);
+    if (timing->receiving == false)
+    {
+        // Start the resampled stream on the first received sample
+        timing->next_date = date;
+        timing->prev_date = date;
+        memcpy(timing->prev, value, stream->data_size);
+        timing->receiving = true;
+    }
+    // Generate the resampled samples dated until this sample
+    while ((int32_t)(date - timing->next_date) >= 0)
+    {
+        float ratio = 1.0f;
+        if (date != timing->prev_date)
+        {
+            ratio = (float)(timing->next_date - timing->prev_date) / (float)(date - timing->prev_date);
+        }
+        for (uint8_t v = 0; v < value_nb; v++)
+        {
+            resampled[v] = timing->prev[v] + (value[v] - timing->prev[v]) * ratio;
+        }
+        Stream_PutSample(stream, resampled, 1);
+        timing->next_date += timing->period;
+    }
+    timing->prev_date = date;
+    memcpy(timing->prev, value, stream->data_size);
+}
+/******************************************************************************
+ * @brief put the samples of a received frame into ring buffer.
+ * Lost frames are counted and samples are resampled if needed.
+ * @param stream streaming channel pointer
+ * @param frame header of the received samples
+ * @param data a pointer to the received samples
+ * @param size The number of received samples
+ * @return None
+ ******************************************************************************/
+void Stream_PutFrame(streaming_channel_t *stream, const stream_frame_t *frame, const void *data, uint16_t size)
+{
+    stream_timing_t *timing = stream->timing;
+    Stream_CheckFrame(stream, frame);
+    if (timing->period == 0)
+    {
+        // No resampling, store samples as received
+        Stream_PutSample(stream, data, size);
+        timing->receiving = true;
+        return;
+    }
+    for (uint16_t i = 0; i < size; i++)
+    {
+        Stream_ResampleSample(stream, frame->timestamp + (i * frame->period), (const uint8_t *)data + (i * stream->data_size));
+    }
+}
+/******************************************************************************
+ * @brief configure the reduction of the samples put in a channel.
+ * The configuration can come from a remote subscriber, it is checked before use.
+ * A channel already using this reducer gets the new configuration at the end of
+ * its current window, applied by the producer, so this can run while the producer puts samples.
+ * @param stream streaming channel pointer
+ * @param reducer reduction state storage
+ * @param reduction configuration to apply
+ * @return error
+ ******************************************************************************/
+error_return_t Stream_SetReduction(streaming_channel_t *stream, stream_reducer_t *reducer, const stream_reduction_t *reduction)
+{
+    LUOS_ASSERT(reducer != NULL);
+    stream_reduction_t config = *reduction;
+    if ((config.mode >= STREAM_REDUCTION_NB) || ((config.mode != STREAM_RAW) && (config.factor == 0)))
+    {
+        return FAILED;
+    }
+    if ((config.mode > STREAM_DECIMATE) && (((stream->data_size % sizeof(float)) != 0) || ((stream->data_size / sizeof(float)) > MAX_STREAM_VALUES)))
+    {
+        // Aggregations are only available for samples made of float values
+        return FAILED;
+    }
+    if ((config.mode == STREAM_LOWPASS) && !((config.alpha > 0.0f) && (config.alpha <= 1.0f)))
     {
-        // The buffer have looped
-        nb_available_sample = ((stream->end_ring_buffer - stream->sample_ptr) + (stream->data_ptr - stream->ring_buffer)) / stream->data_size;
+        return FAILED;
+    }
+    if (config.mode == STREAM_RAW)
+    {
+        config.factor = 1;
+    }
+    if (stream->reducer == reducer)
+    {
+        // The producer may be reducing a window, let it apply the new configuration.
+        // Dates only follow one change, samples of a previous change not sent yet get the new period.
+        Stream_SyncReduction(stream, true);
+        reducer->next_ready = false;
+        reducer->next       = config;
+        reducer->next_ready = true;
+        return SUCCEED;
+    }
+    if (stream->timing != NULL)
+    {
+        // Restart the dates from the next stored sample with the new period
+        stream_timing_t *timing = stream->timing;
+        uint16_t factor         = (stream->reducer != NULL) ? stream->reducer->reduction.factor : 1;
+        timing->origin_date += (stream->head - timing->origin) * timing->period;
+        timing->origin = stream->head;
+        timing->period = (timing->period / factor) * config.factor;
+    }
+    // The producer doesn't use this reducer yet, publish it once ready
+    memset(reducer, 0, sizeof(stream_reducer_t));
+    reducer->reduction = config;
+    stream->reducer    = reducer;
+    return SUCCEED;
+}
+/******************************************************************************
+ * @brief send the samples of a channel using the delta codec.
+ * Sender and receiver have to use the same codec.
+ * @param stream streaming channel pointer
+ * @param value_size size of the integer values of a sample (1, 2 or 4), 0 to send samples as stored
+ * @return None
+ ******************************************************************************/
+void Stream_SetCodec(streaming_channel_t *stream, uint8_t value_size)
+{
+    LUOS_ASSERT((value_size == 0) || (value_size == 1) || (value_size == 2) || (value_size == 4));
+    LUOS_ASSERT((value_size == 0) || (((stream->data_size % value_size) == 0) && ((stream->data_size / value_size) <= MAX_STREAM_VALUES)));
+    stream->codec = value_size;
+}
+/******************************************************************************
+ * @brief compute the zigzag varint of the delta between two values
+ * @param stream streaming channel pointer
+ * @param value current value
+ * @param prev previous value
+ * @param varint buffer of 5 bytes receiving the varint
+ * @return size of the varint
+ ******************************************************************************/
+static uint8_t Stream_EncodeValue(streaming_channel_t *stream, uint32_t value, uint32_t prev, uint8_t *varint)
+{
+    // Sign extend the delta computed on the value size
+    uint8_t shift   = 32 - (stream->codec * 8);
+    uint8_t size    = 0;
+    int32_t delta   = (int32_t)((value - prev) << shift) >> shift;
+    uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    do
+    {
+        varint[size] = (uint8_t)(zigzag & 0x7F);
+        zigzag >>= 7;
+        if (zigzag)
+        {
+            varint[size] |= 0x80;
+        }
+        size++;
+    } while (zigzag);
+    return size;
+}
+/******************************************************************************
+ * @brief encode the samples of a channel into a message payload.
+ * @param stream streaming channel pointer
+ * @param data buffer receiving the encoded samples
+ * @param size size of the buffer
+ * @param sample_nb maximum number of samples to encode, set to the number of encoded samples
+ * @return size of the encoded samples
+ ******************************************************************************/
+uint16_t Stream_EncodeSample(streaming_channel_t *stream, void *data, uint16_t size, uint16_t *sample_nb)
+{
+    uint8_t *buffer        = (uint8_t *)data;
+    const uint8_t value_nb = stream->data_size / stream->codec;
+    stream_span_t spans[2];
+    uint32_t prev[MAX_STREAM_VALUES] = {0};
+    LUOS_ASSERT((stream->codec != 0) && (size > STREAM_CODEC_HEADER_SIZE));
+    uint16_t available = Stream_PeekSpans(stream, spans);
+    if (available > *sample_nb)
+    {
+        available = *sample_nb;
+    }
+    if (available > 0xFF)
+    {
+        available = 0xFF;
+    }
+    // Compute the number of samples we could send as stored
+    uint16_t raw_nb = (size - STREAM_CODEC_HEADER_SIZE) / stream->data_size;
+    if (raw_nb > available)
+    {
+        raw_nb = available;
+    }
+    // Encode samples until the buffer is full
+    uint16_t encoded_size = STREAM_CODEC_HEADER_SIZE;
+    uint16_t encoded_nb   = 0;
+    while (encoded_nb < available)
+    {
+        uint8_t varint[MAX_STREAM_VALUES * 5];
+        uint8_t varint_size   = 0;
+        const uint8_t *sample = (encoded_nb < spans[0].size) ? (const uint8_t *)spans[0].data + (encoded_nb * stream->data_size)
+                                                             : (const uint8_t *)spans[1].data + ((encoded_nb - spans[0].size) * stream->data_size);
+        uint32_t value[MAX_STREAM_VALUES];
+        for (uint8_t v = 0; v < value_nb; v++)
+        {
+            value[v] = 0;
+            for (uint8_t byte = 0; byte < stream->codec; byte++)
+            {
+                value[v] |= (uint32_t)sample[(v * stream->codec) + byte] << (8 * byte);
+            }
+            varint_size += Stream_EncodeValue(stream, value[v], prev[v], &varint[varint_size]);
+        }
+        if ((encoded_size + varint_size) > size)
+        {
+            break;
+        }
+        memcpy(&buffer[encoded_size], varint, varint_size);
+        memcpy(prev, value, sizeof(prev));
+        encoded_size += varint_size;
+        encoded_nb++;
+    }
+    if ((encoded_nb > raw_nb) || ((encoded_nb == raw_nb) && ((encoded_size - STREAM_CODEC_HEADER_SIZE) < (raw_nb * stream->data_size))))
+    {
+        buffer[0] = STREAM_CODEC_DELTA;
+        buffer[1] = (uint8_t)encoded_nb;
+        Stream_CommitRead(stream, encoded_nb);
+        *sample_nb = encoded_nb;
+        return encoded_size;
+    }
+    // Compression doesn't pay off, send samples as stored
+    buffer[0] = STREAM_CODEC_RAW;
+    buffer[1] = (uint8_t)raw_nb;
+    Stream_GetSample(stream, &buffer[STREAM_CODEC_HEADER_SIZE], raw_nb);
+    *sample_nb = raw_nb;
+    return STREAM_CODEC_HEADER_SIZE + (raw_nb * stream->data_size);
+}
+/******************************************************************************
+ * @brief put a decoded sample into ring buffer
+ * @param stream streaming channel pointer
+ * @param frame header of the received samples, NULL if the channel is not timestamped
+ * @param index of the sample in the frame
+ * @param sample a pointer to the sample
+ * @return None
+ ******************************************************************************/
+static void Stream_PutDecodedSample(streaming_channel_t *stream, const stream_frame_t *frame, uint16_t index, const void *sample)
+{
+    if ((frame != NULL) && (stream->timing->period != 0))
+    {
+        Stream_ResampleSample(stream, frame->timestamp + (index * frame->period), sample);
+    }
+    else
+    {
+        Stream_PutSample(stream, sample, 1);
+    }
+}
+/******************************************************************************
+ * @brief decode the samples of a message payload into ring buffer.
+ * Malformed payloads are dropped.
+ * @param stream streaming channel pointer
+ * @param frame header of the received samples, NULL if the channel is not timestamped
+ * @param data a pointer to the encoded samples
+ * @param size size of the encoded samples
+ * @return number of decoded samples
+ ******************************************************************************/
+uint16_t Stream_DecodeSample(streaming_channel_t *stream, const stream_frame_t *frame, const void *data, uint16_t size)
+{
+    const uint8_t *buffer  = (const uint8_t *)data;
+    const uint8_t value_nb = stream->data_size / stream->codec;
+    const uint32_t mask    = 0xFFFFFFFF >> (32 - (stream->codec * 8));
+    uint8_t sample[MAX_STREAM_VALUES * sizeof(uint32_t)];
+    uint32_t prev[MAX_STREAM_VALUES] = {0};
+    LUOS_ASSERT(stream->codec != 0);
+    if (size < STREAM_CODEC_HEADER_SIZE)
+    {
+        return 0;
+    }
+    uint16_t sample_nb = buffer[1];
+    uint16_t position  = STREAM_CODEC_HEADER_SIZE;
+    if (frame != NULL)
+    {
+        Stream_CheckFrame(stream, frame);
+    }
+    if (buffer[0] == STREAM_CODEC_RAW)
+    {
+        if ((STREAM_CODEC_HEADER_SIZE + (sample_nb * stream->data_size)) > size)
+        {
+            return 0;
+        }
+        for (uint16_t i = 0; i < sample_nb; i++)
+        {
+            Stream_PutDecodedSample(stream, frame, i, &buffer[position + (i * stream->data_size)]);
+        }
+    }
+    else if (buffer[0] == STREAM_CODEC_DELTA)
+    {
+        for (uint16_t i = 0; i < sample_nb; i++)
+        {
+            for (uint8_t v = 0; v < value_nb; v++)
+            {
+                // Read the varint
+                uint32_t zigzag = 0;
+                uint8_t shift   = 0;
+                do
+                {
+                    if ((position >= size) || (shift > 28))
+                    {
+                        return i;
+                    }
+                    zigzag |= (uint32_t)(buffer[position] & 0x7F) << shift;
+                    shift += 7;
+                } while (buffer[position++] & 0x80);
+                uint32_t delta = (zigzag >> 1) ^ (uint32_t)(-(int32_t)(zigzag & 1));
+                prev[v]        = (prev[v] + delta) & mask;
+                for (uint8_t byte = 0; byte < stream->codec; byte++)
+                {
+                    sample[(v * stream->codec) + byte] = (uint8_t)(prev[v] >> (8 * byte));
+                }
+            }
+            Stream_PutDecodedSample(stream, frame, i, sample);
+        }
+    }
+    else
+    {
+        return 0;
+    }
+    if (frame != NULL)
+    {
+        stream->timing->receiving = true;
+    }
+    return sample_nb;
+}
+/******************************************************************************
+ * @brief enable the credit based flow control of a channel.
+ * A sender only sends the samples the receiver granted, a receiver counts the
+ * received samples to compute its grants.
+ * @param stream streaming channel pointer
+ * @param credit flow control informations storage
+ * @return None
+ ******************************************************************************/
+void Stream_SetCredit(streaming_channel_t *stream, stream_credit_t *credit)
+{
+    LUOS_ASSERT(credit != NULL);
+    memset(credit, 0, sizeof(stream_credit_t));
+    stream->credit = credit;
+}
+/******************************************************************************
+ * @brief update the sample limit granted by the receiver.
+ * Grants are absolute, an old or duplicated grant is ignored.
+ * @param stream streaming channel pointer
+ * @param limit number of samples the receiver allows to send since the start
+ * @return None
+ ******************************************************************************/
+void Stream_GrantCredit(streaming_channel_t *stream, uint32_t limit)
+{
+    LUOS_ASSERT(stream->credit != NULL);
+    if ((int32_t)(limit - stream->credit->limit) > 0)
+    {
+        stream->credit->limit = limit;
+    }
+}
+/******************************************************************************
+ * @brief return the number of samples a sender is allowed to send
+ * @param stream streaming channel pointer
+ * @return number of samples, 0xFFFF if the channel is not flow controlled
+ ******************************************************************************/
+uint16_t Stream_GetCredit(streaming_channel_t *stream)
+{
+    if (stream->credit == NULL)
+    {
+        return 0xFFFF;
+    }
+    int32_t credit = (int32_t)(stream->credit->limit - stream->credit->count);
+    if (credit <= 0)
+    {
+        return 0;
+    }
+    return (credit > 0xFFFF) ? 0xFFFF : (uint16_t)credit;
+}
+/******************************************************************************
+ * @brief compute the sample limit a receiver can grant to its sender
+ * Grants count received samples, a resampling receiver can store several
+ * samples for each received one and only grants the space they need.
+ * @param stream streaming channel pointer
+ * @return number of samples the sender is allowed to send since the start
+ ******************************************************************************/
+uint32_t Stream_ComputeGrant(streaming_channel_t *stream)
+{
+    LUOS_ASSERT(stream->credit != NULL);
+    stream_timing_t *timing = stream->timing;
+    uint32_t free_space     = stream->mask + 1;
+    if (stream->broadcast == false)
+    {
+        free_space -= Stream_GetAvailableSampleNB(stream);
+    }
+    if ((timing != NULL) && (timing->period != 0))
+    {
+        if (timing->frame_period == 0)
+        {
+            // The sender period is unknown until the first frame, only allow one sample
+            free_space = (free_space > 0) ? 1 : 0;
+        }
+        else
+        {
+            // Each received sample can generate up to this number of resampled samples
+            free_space /= (timing->frame_period + timing->period - 1) / timing->period;
+        }
     }
-    return nb_available_sample;
+    stream->credit->limit = stream->credit->count + free_space;
+    return stream->credit->limit;
 }
@@ -0,0 +1,169 @@
+/******************************************************************************
+ * @file dispatch_bench
+ * @brief host benchmark of the Luos_Loop messages dispatch to containers
+ * @author Luos
+ * @version 0.0.0
+ *
+ * Messages are given to the reception allocator like the bus does, then Luos_Loop
+ * dispatch them to a node having MAX_CONTAINER_NUMBER containers.
+ * Build and run from the repository root, with all the Robus sources:
+ * gcc -std=gnu11 -O2 -no-pie -DMAX_CONTAINER_NUMBER=64 -Itest -Iinc -IOD -IRobus/inc test/dispatch_bench.c test/luos_hal.c src/luos_utils.c src/routing_table.c src/streaming.c Robus/src/[a-z]*.c -lm -o dispatch_bench && ./dispatch_bench
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/luos.c"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define BATCH_NB  16
+#define LOOP_NB   200000
+#define LOOKUP_NB 20000000
+
+// Keep the compiler from removing the benchmarked lookups
+#define BENCH_KEEP(value) __asm__ volatile("" ::"r"(value) : "memory")
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+uint32_t received_nb = 0;
+uint32_t wrong_nb    = 0;
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+static double Bench_Now(void)
+{
+    struct timespec date;
+    clock_gettime(CLOCK_MONOTONIC, &date);
+    return date.tv_sec * 1e9 + date.tv_nsec;
+}
+
+/******************************************************************************
+ * @brief previous Luos_GetContainer, scanning the containers table
+ * @param ll_container to find
+ * @return container
+ ******************************************************************************/
+__attribute__((noinline)) static container_t *Bench_ScanContainer(ll_container_t *ll_container)
+{
+    for (uint16_t i = 0; i < container_number; i++)
+    {
+        if (ll_container == container_table[i].ll_container)
+        {
+            return &container_table[i];
+        }
+    }
+    return 0;
+}
+
+__attribute__((noinline)) static container_t *Bench_IndexContainer(ll_container_t *ll_container)
+{
+    return Luos_GetContainer(ll_container);
+}
+
+/******************************************************************************
+ * @brief containers callback, check the message is for this container
+ * @param container receiving the message
+ * @param msg received
+ * @return None
+ ******************************************************************************/
+static void Bench_Callback(container_t *container, msg_t *msg)
+{
+    received_nb++;
+    if (msg->header.target != container->ll_container->id)
+    {
+        wrong_nb++;
+    }
+}
+
+/******************************************************************************
+ * @brief give a message to the reception allocator like the bus reception does
+ * @param target ID of the container
+ * @return None
+ ******************************************************************************/
+static void Bench_Receive(uint16_t target)
+{
+    header_t header    = {0};
+    uint32_t value     = target;
+    header.target      = target;
+    header.target_mode = ID;
+    header.source      = 1;
+    header.cmd         = LINEAR_POSITION;
+    header.size        = sizeof(value);
+    for (uint8_t i = 0; i < sizeof(header_t); i++)
+    {
+        MsgAlloc_SetData(header.unmap[i]);
+    }
+    MsgAlloc_ValidHeader(true, header.size);
+    for (uint8_t i = 0; i < sizeof(value); i++)
+    {
+        MsgAlloc_SetData(((uint8_t *)&value)[i]);
+    }
+    // CRC
+    MsgAlloc_SetData(0);
+    MsgAlloc_SetData(0);
+    MsgAlloc_EndMsg();
+}
+
+/******************************************************************************
+ * @brief time the lookup of all the containers
+ * @param lookup function to time
+ * @return time of one lookup in ns
+ ******************************************************************************/
+static double Bench_TimeLookup(container_t *(*lookup)(ll_container_t *))
+{
+    double start = Bench_Now();
+    for (uint32_t i = 0; i < LOOKUP_NB; i++)
+    {
+        container_t *container = lookup(container_table[i % container_number].ll_container);
+        BENCH_KEEP(container);
+    }
+    return (Bench_Now() - start) / LOOKUP_NB;
+}
+
+int main(void)
+{
+    revision_t revision = {0};
+    Luos_Init();
+    for (uint16_t i = 0; i < MAX_CONTAINER_NUMBER; i++)
+    {
+        Luos_CreateContainer(Bench_Callback, VOID_MOD, "bench", revision);
+        // No detection on the host, give the IDs
+        container_table[i].ll_container->id = i + 1;
+    }
+    for (uint16_t i = 0; i < container_number; i++)
+    {
+        if ((Bench_IndexContainer(container_table[i].ll_container) != &container_table[i])
+            || (Bench_ScanContainer(container_table[i].ll_container) != &container_table[i]))
+        {
+            printf("container %u not found\n", i);
+            return 1;
+        }
+    }
+    double scan_time  = Bench_TimeLookup(Bench_ScanContainer);
+    double index_time = Bench_TimeLookup(Bench_IndexContainer);
+    printf("%d containers lookup: scan %.1f ns, index %.1f ns (x%.1f)\n", MAX_CONTAINER_NUMBER, scan_time, index_time, scan_time / index_time);
+
+    // Messages for all the containers, the last ones being the slowest to find with a scan
+    uint32_t sent_nb = 0;
+    double start     = Bench_Now();
+    for (uint32_t loop = 0; loop < LOOP_NB; loop++)
+    {
+        for (uint16_t i = 0; i < BATCH_NB; i++)
+        {
+            Bench_Receive(((sent_nb++) % MAX_CONTAINER_NUMBER) + 1);
+        }
+        Luos_Loop();
+    }
+    double dispatch_time = (Bench_Now() - start) / sent_nb;
+    if ((received_nb != sent_nb) || (wrong_nb != 0) || (luos_stats.memory.msg_drop_number != 0))
+    {
+        printf("%u messages received for %u sent, %u to the wrong container, %u dropped\n",
+               received_nb, sent_nb, wrong_nb, luos_stats.memory.msg_drop_number);
+        return 1;
+    }
+    printf("%u messages dispatched to %d containers: %.1f ns per message\n", sent_nb, MAX_CONTAINER_NUMBER, dispatch_time);
+    return 0;
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * @file luosHAL
+ * @brief host stand-in of the LuosHAL for the host programs linking the whole library
+ * There is no bus : nothing is transmitted, the systick only moves when the
+ * host program change hal_tick and the flash is kept in RAM.
+ * @author Luos
+ * @version 0.0.0
+ ******************************************************************************/
+#include <string.h>
+#include "luos_hal.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define HAL_FLASH_SIZE 1024
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+volatile uint32_t hal_tick = 0;
+uint32_t hal_uuid[3]       = {0x484F5354, 0x4C554F53, 0x00000001};
+uint8_t hal_flash[HAL_FLASH_SIZE];
+uint8_t hal_flash_erased = false;
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+void LuosHAL_Init(void)
+{
+    if (hal_flash_erased == false)
+    {
+        memset(hal_flash, 0xFF, sizeof(hal_flash));
+        hal_flash_erased = true;
+    }
+}
+
+void LuosHAL_SetIrqState(uint8_t Enable)
+{
+    (void)Enable;
+}
+
+uint32_t LuosHAL_GetSystick(void)
+{
+    return hal_tick;
+}
+
+void LuosHAL_ComInit(uint32_t Baudrate)
+{
+    (void)Baudrate;
+}
+
+void LuosHAL_SetTxState(uint8_t Enable)
+{
+    (void)Enable;
+}
+
+void LuosHAL_SetRxState(uint8_t Enable)
+{
+    (void)Enable;
+}
+
+void LuosHAL_ComTransmit(unsigned char *data, uint16_t size)
+{
+    (void)data;
+    (void)size;
+}
+
+void LuosHAL_SetRxDetecPin(uint8_t Enable)
+{
+    (void)Enable;
+}
+
+uint8_t LuosHAL_GetTxLockState(void)
+{
+    return false;
+}
+
+void LuosHAL_ResetTimeout(uint16_t nbrbit)
+{
+    (void)nbrbit;
+}
+
+void LuosHAL_SetPTPDefaultState(uint8_t PortNbr)
+{
+    (void)PortNbr;
+}
+
+void LuosHAL_SetPTPReverseState(uint8_t PortNbr)
+{
+    (void)PortNbr;
+}
+
+void LuosHAL_PushPTP(uint8_t PortNbr)
+{
+    (void)PortNbr;
+}
+
+uint8_t LuosHAL_GetPTPState(uint8_t PortNbr)
+{
+    (void)PortNbr;
+    return false;
+}
+
+void LuosHAL_ComputeCRC(uint8_t *data, uint8_t *crc)
+{
+    uint16_t value = 0;
+    memcpy(&value, crc, sizeof(uint16_t));
+    value ^= (uint16_t)(*data) << 8;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        value = (value & 0x8000) ? (uint16_t)((value << 1) ^ 0x0007) : (uint16_t)(value << 1);
+    }
+    memcpy(crc, &value, sizeof(uint16_t));
+}
+
+void LuosHAL_FlashWriteLuosMemoryInfo(uint32_t addr, uint16_t size, uint8_t *data)
+{
+    LuosHAL_Init();
+    if ((addr + size) <= HAL_FLASH_SIZE)
+    {
+        memcpy(&hal_flash[addr], data, size);
+    }
+}
+
+void LuosHAL_FlashReadLuosMemoryInfo(uint32_t addr, uint16_t size, uint8_t *data)
+{
+    LuosHAL_Init();
+    memset(data, 0xFF, size);
+    if ((addr + size) <= HAL_FLASH_SIZE)
+    {
+        memcpy(data, &hal_flash[addr], size);
+    }
+}
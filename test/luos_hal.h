@@ -0,0 +1,47 @@
+/******************************************************************************
+ * @file luosHAL
+ * @brief host stand-in of the LuosHAL header for the host tests
+ * @author Luos
+ * @version 0.0.0
+ ******************************************************************************/
+#ifndef _LUOSHAL_H_
+#define _LUOSHAL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define LUOS_UUID             (hal_uuid)
+#define ADDRESS_ALIASES_FLASH 0
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+// Implemented by test/luos_hal.c for the host programs linking the whole library
+extern volatile uint32_t hal_tick; // Systick in ms, moved by the host program
+extern uint32_t hal_uuid[3];
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+void LuosHAL_Init(void);
+void LuosHAL_SetIrqState(uint8_t Enable);
+uint32_t LuosHAL_GetSystick(void);
+void LuosHAL_ComInit(uint32_t Baudrate);
+void LuosHAL_SetTxState(uint8_t Enable);
+void LuosHAL_SetRxState(uint8_t Enable);
+void LuosHAL_ComTransmit(unsigned char *data, uint16_t size);
+void LuosHAL_SetRxDetecPin(uint8_t Enable);
+uint8_t LuosHAL_GetTxLockState(void);
+void LuosHAL_ResetTimeout(uint16_t nbrbit);
+void LuosHAL_SetPTPDefaultState(uint8_t PortNbr);
+void LuosHAL_SetPTPReverseState(uint8_t PortNbr);
+void LuosHAL_PushPTP(uint8_t PortNbr);
+uint8_t LuosHAL_GetPTPState(uint8_t PortNbr);
+void LuosHAL_ComputeCRC(uint8_t *data, uint8_t *crc);
+void LuosHAL_FlashWriteLuosMemoryInfo(uint32_t addr, uint16_t size, uint8_t *data);
+void LuosHAL_FlashReadLuosMemoryInfo(uint32_t addr, uint16_t size, uint8_t *data);
+
+#endif /* _LUOSHAL_H_ */
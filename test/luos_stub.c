@@ -0,0 +1,61 @@
+/******************************************************************************
+ * @file luos_stub
+ * @brief host stand-in of the Luos and Robus functions used by the routing_table
+ * @author Luos
+ * @version 0.0.0
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "luos.h"
+#include "robus.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+void Luos_assert(char *file, uint32_t line)
+{
+    printf("assert %s:%u\n", file, (unsigned int)line);
+    exit(1);
+}
+
+uint32_t Luos_GetSystick(void)
+{
+    return 0;
+}
+
+void Luos_Loop(void) {}
+
+error_return_t Luos_SendMsg(container_t *container, msg_t *msg)
+{
+    (void)container;
+    (void)msg;
+    return SUCCEED;
+}
+
+void Luos_TimerStart(container_t *container, luos_timer_t *timer, uint32_t delay_ms, uint32_t period_ms, TIMER_CB callback)
+{
+    (void)container;
+    (void)timer;
+    (void)delay_ms;
+    (void)period_ms;
+    (void)callback;
+}
+
+void Luos_TimerStop(luos_timer_t *timer)
+{
+    (void)timer;
+}
+
+uint16_t Robus_TopologyDetection(ll_container_t *ll_container)
+{
+    (void)ll_container;
+    return 0;
+}
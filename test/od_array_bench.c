@@ -0,0 +1,142 @@
+/******************************************************************************
+ * @file od_array_bench
+ * @brief host benchmark of the OD array conversions against scalar loops
+ * @author Luos
+ * @version 0.0.0
+ *
+ * Build and run from the repository root (add -DOD_FIXED_POINT for Q16.16):
+ * gcc -std=gnu11 -O2 -Iinc -IOD -IRobus/inc test/od_array_bench.c -lm -o od_array_bench && ./od_array_bench
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "luos.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define SAMPLE_NB 64
+#define LOOP_NB   2000000
+
+// Keep the compiler from removing the benchmarked conversions
+#define BENCH_KEEP(buffer) __asm__ volatile("" ::"r"(buffer) : "memory")
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+od_value_t source[SAMPLE_NB];
+od_value_t scalar_result[SAMPLE_NB];
+od_value_t array_result[SAMPLE_NB];
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+// The OD headers only need an assertion handler
+void Luos_assert(char *file, uint32_t line)
+{
+    printf("assert %s:%u\n", file, (unsigned int)line);
+}
+
+static double Bench_Now(void)
+{
+    struct timespec date;
+    clock_gettime(CLOCK_MONOTONIC, &date);
+    return date.tv_sec * 1e9 + date.tv_nsec;
+}
+
+__attribute__((noinline)) static void Bench_PositionScalar(od_value_t *dst, const od_value_t *src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = LinearOD_PositionFrom_mm(src[i]);
+    }
+}
+
+__attribute__((noinline)) static void Bench_PositionArray(od_value_t *dst, const od_value_t *src, uint16_t n)
+{
+    LinearOD_PositionFrom_mm_array(dst, src, n);
+}
+
+__attribute__((noinline)) static void Bench_TemperatureScalar(od_value_t *dst, const od_value_t *src, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++)
+    {
+        dst[i] = TemperatureOD_TemperatureFrom_deg_f(src[i]);
+    }
+}
+
+__attribute__((noinline)) static void Bench_TemperatureArray(od_value_t *dst, const od_value_t *src, uint16_t n)
+{
+    TemperatureOD_TemperatureFrom_deg_f_array(dst, src, n);
+}
+
+/******************************************************************************
+ * @brief check that the array conversion gives the scalar results
+ * @return true if all the samples match
+ ******************************************************************************/
+static uint8_t Bench_Match(void)
+{
+    for (uint16_t i = 0; i < SAMPLE_NB; i++)
+    {
+#ifdef OD_FIXED_POINT
+        // Both conversions round the same constant, allow one count of difference
+        if (labs((long)scalar_result[i] - (long)array_result[i]) > 1)
+#else
+        // Reciprocal multiplies can differ from divides by a few ulp
+        if (fabs((double)scalar_result[i] - (double)array_result[i]) > (fabs((double)scalar_result[i]) * 1e-6))
+#endif
+        {
+            printf("sample %u mismatch\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief time a conversion of SAMPLE_NB samples
+ * @param convert conversion to time
+ * @param dst result buffer
+ * @return time of one conversion in ns
+ ******************************************************************************/
+static double Bench_Time(void (*convert)(od_value_t *, const od_value_t *, uint16_t), od_value_t *dst)
+{
+    double start = Bench_Now();
+    for (uint32_t i = 0; i < LOOP_NB; i++)
+    {
+        convert(dst, source, SAMPLE_NB);
+        BENCH_KEEP(dst);
+    }
+    return (Bench_Now() - start) / LOOP_NB;
+}
+
+int main(void)
+{
+    uint8_t success = true;
+    for (uint16_t i = 0; i < SAMPLE_NB; i++)
+    {
+#ifdef OD_FIXED_POINT
+        source[i] = OD_FIXED(i * 13.7 - 300.0);
+#else
+        source[i] = i * 13.7f - 300.0f;
+#endif
+    }
+
+    Bench_PositionScalar(scalar_result, source, SAMPLE_NB);
+    Bench_PositionArray(array_result, source, SAMPLE_NB);
+    success &= Bench_Match();
+    double scalar_time = Bench_Time(Bench_PositionScalar, scalar_result);
+    double array_time  = Bench_Time(Bench_PositionArray, array_result);
+    printf("%d samples from mm: scalar loop %.1f ns, array %.1f ns (x%.1f)\n", SAMPLE_NB, scalar_time, array_time, scalar_time / array_time);
+
+    Bench_TemperatureScalar(scalar_result, source, SAMPLE_NB);
+    Bench_TemperatureArray(array_result, source, SAMPLE_NB);
+    success &= Bench_Match();
+    scalar_time = Bench_Time(Bench_TemperatureScalar, scalar_result);
+    array_time  = Bench_Time(Bench_TemperatureArray, array_result);
+    printf("%d samples from deg_f: scalar loop %.1f ns, array %.1f ns (x%.1f)\n", SAMPLE_NB, scalar_time, array_time, scalar_time / array_time);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+/******************************************************************************
+ * @file routing_table_alias_bench
+ * @brief host benchmark of the routing_table aliases de-duplication
+ * @author Luos
+ * @version 0.0.0
+ *
+ * The routing_table source is included to reach its static functions, test/luos_stub.c
+ * provides the Luos and Robus functions it uses.
+ * Build and run from the repository root:
+ * gcc -std=gnu11 -O2 -Itest -Iinc -IOD -IRobus/inc test/routing_table_alias_bench.c test/luos_stub.c -o routing_table_alias_bench && ./routing_table_alias_bench
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MAX_RTB_CONTAINER 512
+#include "../src/routing_table.c"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define IDENTICAL_NB    500
+#define REFERENCE_NB    99 // The previous algorithm only handle 2 digits numbers
+#define MIXED_NB        200
+#define LOOP_NB         200
+#define REFERENCE_ERROR "error"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+const char *mixed_alias[] = {"motor", "led", "motor1", "verylongaliasxx", "gate", "led1", "verylongaliasx1"};
+char reference_alias[MAX_RTB_CONTAINER][MAX_ALIAS_SIZE];
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+static double Bench_Now(void)
+{
+    struct timespec date;
+    clock_gettime(CLOCK_MONOTONIC, &date);
+    return date.tv_sec * 1e9 + date.tv_nsec;
+}
+
+/******************************************************************************
+ * @brief previous alias search, a linear scan of the routing_table
+ * @param nb number of aliases
+ * @param alias to find
+ * @return index of the first container with this alias
+ ******************************************************************************/
+static uint16_t Reference_IndexFromAlias(uint16_t nb, const char *alias)
+{
+    for (uint16_t i = 0; i < nb; i++)
+    {
+        if (strcmp(reference_alias[i], alias) == 0)
+        {
+            return i;
+        }
+    }
+    return 0xFFFF;
+}
+
+/******************************************************************************
+ * @brief previous number addition, limited to 2 digits
+ * @param alias to change
+ * @param num to add
+ * @return None
+ ******************************************************************************/
+static void Reference_AddNumToAlias(char *alias, uint8_t num)
+{
+    char base[MAX_ALIAS_SIZE];
+    uint8_t intsize = (num > 9) ? 2 : 1;
+    if (num > 99)
+    {
+        memset(alias, 0, MAX_ALIAS_SIZE);
+        memcpy(alias, REFERENCE_ERROR, strlen(REFERENCE_ERROR));
+        return;
+    }
+    memcpy(base, alias, MAX_ALIAS_SIZE);
+    if (strlen(base) > (size_t)(ALIAS_SIZE - intsize))
+    {
+        base[(ALIAS_SIZE - intsize)] = '\0';
+    }
+    snprintf(alias, MAX_ALIAS_SIZE, "%s%d", base, num);
+}
+
+/******************************************************************************
+ * @brief previous de-duplication, searching each candidate alias in the whole table
+ * @param nb number of aliases
+ * @return None
+ ******************************************************************************/
+static void Reference_Deduplicate(uint16_t nb)
+{
+    for (uint16_t i = 0; i < nb; i++)
+    {
+        if (Reference_IndexFromAlias(nb, reference_alias[i]) != i)
+        {
+            uint8_t annotation              = 1;
+            char base_alias[MAX_ALIAS_SIZE] = {0};
+            memcpy(base_alias, reference_alias[i], MAX_ALIAS_SIZE);
+            Reference_AddNumToAlias(reference_alias[i], annotation++);
+            while (Reference_IndexFromAlias(nb, reference_alias[i]) != i)
+            {
+                memcpy(reference_alias[i], base_alias, MAX_ALIAS_SIZE);
+                Reference_AddNumToAlias(reference_alias[i], annotation++);
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief fill both routing_tables with the same aliases
+ * @param aliases list to repeat
+ * @param alias_nb size of the list
+ * @param nb number of containers
+ * @return None
+ ******************************************************************************/
+static void Bench_Fill(const char **aliases, uint16_t alias_nb, uint16_t nb)
+{
+    uint16_t port = 0;
+    RoutingTB_Erase();
+    RoutingTB_AddNode(1, false, &port, 1);
+    for (uint16_t i = 0; i < nb; i++)
+    {
+        RoutingTB_AddContainer(i + 1, VOID_MOD, aliases[i % alias_nb], 0);
+        memset(reference_alias[i], 0, MAX_ALIAS_SIZE);
+        strncpy(reference_alias[i], aliases[i % alias_nb], ALIAS_SIZE);
+    }
+}
+
+/******************************************************************************
+ * @brief check the routing_table aliases
+ * @param nb number of containers
+ * @param reference compare the aliases with the previous algorithm ones
+ * @return true if all the aliases are unique and match the reference
+ ******************************************************************************/
+static uint8_t Bench_Check(uint16_t nb, uint8_t reference)
+{
+    char alias[MAX_ALIAS_SIZE];
+    char other_alias[MAX_ALIAS_SIZE];
+    for (uint16_t i = 0; i < nb; i++)
+    {
+        RoutingTB_BuildAlias(&rtb_containers[i], alias);
+        if (reference && (strcmp(alias, reference_alias[i]) != 0))
+        {
+            printf("container %u is %s instead of %s\n", i, alias, reference_alias[i]);
+            return false;
+        }
+        for (uint16_t j = 0; j < i; j++)
+        {
+            RoutingTB_BuildAlias(&rtb_containers[j], other_alias);
+            if (strcmp(alias, other_alias) == 0)
+            {
+                printf("containers %u and %u are both %s\n", j, i, alias);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief time the de-duplication of a routing_table
+ * @param nb number of containers
+ * @return time of one de-duplication in us
+ ******************************************************************************/
+static double Bench_Time(uint16_t nb)
+{
+    double start = Bench_Now();
+    for (uint16_t loop = 0; loop < LOOP_NB; loop++)
+    {
+        for (uint16_t i = 0; i < nb; i++)
+        {
+            rtb_containers[i].alias_suffix = 0;
+        }
+        RoutingTB_DeduplicateAliases();
+    }
+    return (Bench_Now() - start) / LOOP_NB / 1000.0;
+}
+
+/******************************************************************************
+ * @brief time the previous de-duplication
+ * @param aliases list to repeat
+ * @param nb number of containers
+ * @return time of one de-duplication in us
+ ******************************************************************************/
+static double Bench_ReferenceTime(const char **aliases, uint16_t nb)
+{
+    double start = Bench_Now();
+    for (uint16_t loop = 0; loop < LOOP_NB; loop++)
+    {
+        for (uint16_t i = 0; i < nb; i++)
+        {
+            strncpy(reference_alias[i], aliases[0], ALIAS_SIZE);
+        }
+        Reference_Deduplicate(nb);
+    }
+    return (Bench_Now() - start) / LOOP_NB / 1000.0;
+}
+
+int main(void)
+{
+    const char *identical_alias[] = {"dummy"};
+    uint8_t success               = true;
+
+    // Same names than the previous algorithm on a mix of colliding aliases
+    Bench_Fill(mixed_alias, sizeof(mixed_alias) / sizeof(mixed_alias[0]), MIXED_NB);
+    RoutingTB_DeduplicateAliases();
+    Reference_Deduplicate(MIXED_NB);
+    success &= Bench_Check(MIXED_NB, true);
+
+    // Timing against the previous algorithm in its 2 digits limit
+    Bench_Fill(identical_alias, 1, REFERENCE_NB);
+    double time           = Bench_Time(REFERENCE_NB);
+    double reference_time = Bench_ReferenceTime(identical_alias, REFERENCE_NB);
+    success &= Bench_Check(REFERENCE_NB, true);
+    printf("%d identical aliases: %.1f us, previous algorithm %.1f us (x%.0f)\n", REFERENCE_NB, time, reference_time, reference_time / time);
+
+    // Numbers over 2 digits
+    Bench_Fill(identical_alias, 1, IDENTICAL_NB);
+    time = Bench_Time(IDENTICAL_NB);
+    success &= Bench_Check(IDENTICAL_NB, false);
+    printf("%d identical aliases: %.1f us\n", IDENTICAL_NB, time);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * @file routing_table_alias_pool_test
+ * @brief host test of the routing_table alias pool when containers are renamed, added and removed
+ * @author Luos
+ * @version 0.0.0
+ *
+ * Renamed and removed containers leave their alias base into the alias pool, it must be compacted
+ * instead of giving no alias to the next containers. A pool too small to store all the aliases
+ * must be reported.
+ * Build and run from the repository root:
+ * gcc -std=gnu11 -O2 -Itest -Iinc -IOD -IRobus/inc test/routing_table_alias_pool_test.c test/luos_stub.c -o routing_table_alias_pool_test && ./routing_table_alias_pool_test
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/routing_table.c"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define NODE_ID      1
+#define CONTAINER_NB 8
+#define CHURN_NB     2000
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+/******************************************************************************
+ * @brief check the alias of a container
+ * @param id of the container
+ * @param alias expected
+ * @return true if the container have this alias
+ ******************************************************************************/
+static uint8_t Test_CheckAlias(uint16_t id, const char *alias)
+{
+    char *container_alias = RoutingTB_AliasFromId(id);
+    if ((container_alias == NULL) || (strcmp(container_alias, alias) != 0))
+    {
+        printf("container %u is named \"%s\" instead of \"%s\"\n", id, container_alias ? container_alias : "", alias);
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief rename, add and remove containers with always new aliases
+ * @return true if all the containers keep the right alias
+ ******************************************************************************/
+static uint8_t Test_Churn(void)
+{
+    char alias[MAX_ALIAS_SIZE];
+    uint16_t port = 0;
+    RoutingTB_Erase();
+    RoutingTB_AddNode(NODE_ID, false, &port, 1);
+    for (uint16_t id = 1; id <= CONTAINER_NB; id++)
+    {
+        sprintf(alias, "fixed_%u", id);
+        RoutingTB_AddContainer(id, VOID_MOD, alias, 0);
+    }
+    RoutingTB_ComputeSearchLists();
+    for (uint16_t i = 0; i < CHURN_NB; i++)
+    {
+        // Rename the first container, replace the last one
+        sprintf(alias, "renamed_%u", i);
+        if (RoutingTB_DeltaRename(NULL, 1, alias) == FAILED)
+        {
+            printf("rename %u failed\n", i);
+            return false;
+        }
+        if (Test_CheckAlias(1, alias) == false)
+        {
+            return false;
+        }
+        sprintf(alias, "added_%u", i);
+        if ((RoutingTB_DeltaRemove(NULL, CONTAINER_NB) == FAILED)
+            || (RoutingTB_DeltaAdd(NULL, NODE_ID, CONTAINER_NB, VOID_MOD, alias) == FAILED))
+        {
+            printf("replace %u failed\n", i);
+            return false;
+        }
+        if (Test_CheckAlias(CONTAINER_NB, alias) == false)
+        {
+            return false;
+        }
+    }
+    for (uint16_t id = 2; id < CONTAINER_NB; id++)
+    {
+        sprintf(alias, "fixed_%u", id);
+        if (Test_CheckAlias(id, alias) == false)
+        {
+            return false;
+        }
+    }
+    return RoutingTB_GetMissingAliasNB() == 0;
+}
+
+/******************************************************************************
+ * @brief fill the routing_table with more different aliases than the pool can store
+ * @return true if the missing aliases are reported and a failed rename keep the previous alias
+ ******************************************************************************/
+static uint8_t Test_Exhaustion(void)
+{
+    char alias[MAX_ALIAS_SIZE];
+    uint16_t port         = 0;
+    uint16_t missing_nb   = 0;
+    error_return_t result = SUCCEED;
+    RoutingTB_Erase();
+    RoutingTB_AddNode(NODE_ID, false, &port, 1);
+    // The short alias don't release enough memory to rename it with a long one
+    RoutingTB_AddContainer(1, VOID_MOD, "a", 0);
+    for (uint16_t id = 2; id <= MAX_RTB_CONTAINER; id++)
+    {
+        sprintf(alias, "long_alias%04u", id);
+        if (RoutingTB_AddContainer(id, VOID_MOD, alias, 0) == FAILED)
+        {
+            missing_nb++;
+        }
+    }
+    RoutingTB_ComputeSearchLists();
+    if ((missing_nb == 0) || (RoutingTB_GetMissingAliasNB() != missing_nb))
+    {
+        printf("%u missing aliases reported instead of %u\n", RoutingTB_GetMissingAliasNB(), missing_nb);
+        return false;
+    }
+    result = RoutingTB_DeltaRename(NULL, 1, "another_alias15");
+    if ((result != FAILED) || (Test_CheckAlias(1, "a") == false))
+    {
+        printf("rename on a full alias pool not reported\n");
+        return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    if (Test_Churn() == false)
+    {
+        printf("alias pool churn failed\n");
+        return 1;
+    }
+    printf("%u renames and replacements, alias pool %u/%u bytes\n", CHURN_NB, rtb_alias_pool_size, RTB_ALIAS_POOL_SIZE);
+    if (Test_Exhaustion() == false)
+    {
+        printf("alias pool exhaustion failed\n");
+        return 1;
+    }
+    printf("%u containers without alias reported\n", RoutingTB_GetMissingAliasNB());
+    return 0;
+}
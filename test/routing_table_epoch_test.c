@@ -0,0 +1,101 @@
+/******************************************************************************
+ * @file routing_table_epoch_test
+ * @brief host test of the routing_table epoch when a node is removed
+ * @author Luos
+ * @version 0.0.0
+ *
+ * Every container of a node handle the ASSERT of an other node, so a node with several containers
+ * call RoutingTB_RemoveNode several times. It must reach the same epoch and hash than a node calling
+ * it once, or the nodes would stop sharing the same routing_table.
+ * Build and run from the repository root:
+ * gcc -std=gnu11 -O2 -Itest -Iinc -IOD -IRobus/inc test/routing_table_epoch_test.c test/luos_stub.c -o routing_table_epoch_test && ./routing_table_epoch_test
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/routing_table.c"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define REMOVED_NODE     2
+#define REMOVED_CONT_NB  4
+#define START_EPOCH      7
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+/******************************************************************************
+ * @brief fill the routing_table with 3 nodes, the second one having REMOVED_CONT_NB containers
+ * @param None
+ * @return None
+ ******************************************************************************/
+static void Test_Fill(void)
+{
+    uint16_t port = 0;
+    uint16_t id   = 1;
+    RoutingTB_Erase();
+    RoutingTB_AddNode(1, false, &port, 1);
+    RoutingTB_AddContainer(id++, VOID_MOD, "gate", 0);
+    RoutingTB_AddNode(REMOVED_NODE, false, &port, 1);
+    for (uint16_t i = 0; i < REMOVED_CONT_NB; i++)
+    {
+        RoutingTB_AddContainer(id++, STATE_MOD, "button", 0);
+    }
+    RoutingTB_AddNode(3, false, &port, 1);
+    RoutingTB_AddContainer(id++, DCMOTOR_MOD, "motor", 0);
+    RoutingTB_AddContainer(id++, COLOR_MOD, "led", 0);
+    RoutingTB_DeduplicateAliases();
+    RoutingTB_ComputeSearchLists();
+    RoutingTB_SetEpoch(START_EPOCH);
+    rtb_hash = RoutingTB_ComputeHash();
+}
+
+/******************************************************************************
+ * @brief remove the REMOVED_NODE node as many times as asked
+ * @param call_nb number of RoutingTB_RemoveNode calls
+ * @param hash filled with the resulting routing_table hash
+ * @return resulting epoch
+ ******************************************************************************/
+static uint16_t Test_Remove(uint16_t call_nb, uint32_t *hash)
+{
+    Test_Fill();
+    for (uint16_t i = 0; i < call_nb; i++)
+    {
+        RoutingTB_RemoveNode(REMOVED_NODE);
+    }
+    *hash = rtb_hash;
+    return RoutingTB_GetEpoch();
+}
+
+int main(void)
+{
+    uint32_t once_hash;
+    uint32_t several_hash;
+    uint16_t once_epoch    = Test_Remove(1, &once_hash);
+    uint16_t several_epoch = Test_Remove(REMOVED_CONT_NB, &several_hash);
+    if ((once_epoch != START_EPOCH + 1) || (several_epoch != once_epoch) || (several_hash != once_hash))
+    {
+        printf("epoch %u hash %08X after one removal, epoch %u hash %08X after %u removals\n",
+               once_epoch, (unsigned int)once_hash, several_epoch, (unsigned int)several_hash, REMOVED_CONT_NB);
+        return 1;
+    }
+    if (rtb_container_nb != 3)
+    {
+        printf("%u containers left instead of 3\n", rtb_container_nb);
+        return 1;
+    }
+    // An unknown node doesn't change anything
+    RoutingTB_RemoveNode(42);
+    if ((RoutingTB_GetEpoch() != once_epoch) || (rtb_hash != once_hash))
+    {
+        printf("removing an unknown node changed the epoch\n");
+        return 1;
+    }
+    printf("node removed %u times, epoch %u hash %08X\n", REMOVED_CONT_NB, several_epoch, (unsigned int)several_hash);
+    return 0;
+}
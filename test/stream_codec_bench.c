@@ -0,0 +1,182 @@
+/******************************************************************************
+ * @file stream_codec_bench
+ * @brief host benchmark of the streaming delta codec on recorded like signals
+ * @author Luos
+ * @version 0.0.0
+ *
+ * Each signal is encoded in messages of MAX_DATA_MSG_SIZE bytes, decoded and compared to the
+ * original samples. The wire size (payload, header and CRC) is compared to sending the samples as stored.
+ * Build and run from the repository root:
+ * gcc -std=gnu11 -O2 -Iinc -IOD -IRobus/inc test/stream_codec_bench.c src/streaming.c -lm -o stream_codec_bench && ./stream_codec_bench
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "streaming.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define SAMPLE_NB      2000
+#define RING_SIZE      4096 // Power of 2 bigger than SAMPLE_NB
+#define MAX_DATA_SIZE  8
+#define MSG_OVERHEAD   (sizeof(header_t) + 2) // Header and CRC of each message
+#define MAX_MSG_NUMBER SAMPLE_NB
+#define LOOP_NB        200
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+uint8_t signal_buffer[SAMPLE_NB * MAX_DATA_SIZE];
+uint8_t decoded_buffer[SAMPLE_NB * MAX_DATA_SIZE];
+uint8_t tx_ring[RING_SIZE * MAX_DATA_SIZE];
+uint8_t rx_ring[RING_SIZE * MAX_DATA_SIZE];
+uint8_t msg_data[MAX_MSG_NUMBER][MAX_DATA_MSG_SIZE];
+uint16_t msg_size[MAX_MSG_NUMBER];
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+// Streaming only need an assertion handler
+void Luos_assert(char *file, uint32_t line)
+{
+    printf("assert %s:%u\n", file, (unsigned int)line);
+    exit(1);
+}
+
+static double Bench_Now(void)
+{
+    struct timespec date;
+    clock_gettime(CLOCK_MONOTONIC, &date);
+    return date.tv_sec * 1e9 + date.tv_nsec;
+}
+
+/******************************************************************************
+ * @brief encode all the samples of a channel into messages
+ * @param stream to encode
+ * @return number of messages
+ ******************************************************************************/
+static uint16_t Bench_Encode(streaming_channel_t *stream)
+{
+    uint16_t msg_nb = 0;
+    while ((Stream_GetAvailableSampleNB(stream) > 0) && (msg_nb < MAX_MSG_NUMBER))
+    {
+        uint16_t sample_nb = 0xFFFF;
+        msg_size[msg_nb]   = Stream_EncodeSample(stream, msg_data[msg_nb], MAX_DATA_MSG_SIZE, &sample_nb);
+        msg_nb++;
+    }
+    return msg_nb;
+}
+
+/******************************************************************************
+ * @brief encode and decode a signal, check it and print its compression ratio and cost
+ * @param name of the signal
+ * @param data_size size of a sample
+ * @param value_size size of the integer values of a sample
+ * @param max_ratio worst wire size ratio expected against samples sent as stored
+ * @return true if the signal is decoded as sent with the expected ratio
+ ******************************************************************************/
+static uint8_t Bench_Signal(const char *name, uint8_t data_size, uint8_t value_size, double max_ratio)
+{
+    streaming_channel_t tx = Stream_CreateStreamingChannel(tx_ring, RING_SIZE, data_size);
+    streaming_channel_t rx = Stream_CreateStreamingChannel(rx_ring, RING_SIZE, data_size);
+    Stream_SetCodec(&tx, value_size);
+    Stream_SetCodec(&rx, value_size);
+
+    // Check the round trip
+    Stream_PutSample(&tx, signal_buffer, SAMPLE_NB);
+    uint16_t msg_nb    = Bench_Encode(&tx);
+    uint32_t wire_size = 0;
+    for (uint16_t i = 0; i < msg_nb; i++)
+    {
+        Stream_DecodeSample(&rx, NULL, msg_data[i], msg_size[i]);
+        wire_size += msg_size[i] + MSG_OVERHEAD;
+    }
+    uint16_t decoded_nb = Stream_GetAvailableSampleNB(&rx);
+    Stream_GetSample(&rx, decoded_buffer, decoded_nb);
+    if ((decoded_nb != SAMPLE_NB) || (memcmp(signal_buffer, decoded_buffer, SAMPLE_NB * data_size) != 0))
+    {
+        printf("%s isn't decoded as sent\n", name);
+        return false;
+    }
+    // Samples sent as stored fill the messages
+    uint32_t raw_msg_nb = ((SAMPLE_NB * data_size) + MAX_DATA_MSG_SIZE - 1) / MAX_DATA_MSG_SIZE;
+    uint32_t raw_size   = (SAMPLE_NB * data_size) + (raw_msg_nb * MSG_OVERHEAD);
+    double ratio        = (double)wire_size / raw_size;
+
+    // Time the codec
+    double start = Bench_Now();
+    for (uint16_t loop = 0; loop < LOOP_NB; loop++)
+    {
+        Stream_ResetStreamingChannel(&tx);
+        Stream_PutSample(&tx, signal_buffer, SAMPLE_NB);
+        Bench_Encode(&tx);
+    }
+    double encode_time = (Bench_Now() - start) / ((double)LOOP_NB * SAMPLE_NB);
+    start              = Bench_Now();
+    for (uint16_t loop = 0; loop < LOOP_NB; loop++)
+    {
+        Stream_ResetStreamingChannel(&rx);
+        for (uint16_t i = 0; i < msg_nb; i++)
+        {
+            Stream_DecodeSample(&rx, NULL, msg_data[i], msg_size[i]);
+        }
+    }
+    double decode_time = (Bench_Now() - start) / ((double)LOOP_NB * SAMPLE_NB);
+    printf("%-20s %3u messages, %5u bytes instead of %5u (ratio %.2f), encode %.1f ns, decode %.1f ns per sample\n",
+           name, msg_nb, wire_size, raw_size, ratio, encode_time, decode_time);
+    if (ratio > max_ratio)
+    {
+        printf("%s ratio %.2f is over %.2f\n", name, ratio, max_ratio);
+        return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    uint8_t success = true;
+    int32_t *ticks  = (int32_t *)signal_buffer;
+    int16_t *values = (int16_t *)signal_buffer;
+    srand(1);
+
+    // Encoder ticks of a motor turning at a nearly constant speed
+    int32_t position = 100000;
+    for (uint16_t i = 0; i < SAMPLE_NB; i++)
+    {
+        position += 20 + (rand() % 5) - 2;
+        ticks[i] = position;
+    }
+    success &= Bench_Signal("encoder ticks int32", sizeof(int32_t), sizeof(int32_t), 0.35);
+
+    // Slowly drifting temperature in 0.01 degree
+    int16_t temperature = 2350;
+    for (uint16_t i = 0; i < SAMPLE_NB; i++)
+    {
+        if ((rand() % 8) == 0)
+        {
+            temperature += (rand() % 3) - 1;
+        }
+        values[i] = temperature;
+    }
+    success &= Bench_Signal("temperature int16", sizeof(int16_t), sizeof(int16_t), 0.6);
+
+    // Noisy 3 axis accelerometer
+    for (uint16_t i = 0; i < SAMPLE_NB * 3; i++)
+    {
+        values[i] = (int16_t)(1000 * sin((i / 3) * 0.01) + (i % 3) * 300 + (rand() % 7));
+    }
+    success &= Bench_Signal("3 axis accel int16", 3 * sizeof(int16_t), sizeof(int16_t), 0.6);
+
+    // Random values don't compress, they are sent as stored with the codec header
+    for (uint16_t i = 0; i < SAMPLE_NB; i++)
+    {
+        values[i] = (int16_t)rand();
+    }
+    success &= Bench_Signal("random int16", sizeof(int16_t), sizeof(int16_t), 1.05);
+
+    return success ? 0 : 1;
+}
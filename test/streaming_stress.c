@@ -0,0 +1,271 @@
+/******************************************************************************
+ * @file streaming_stress
+ * @brief host stress test of the streaming channel SPSC ring
+ * @author Luos
+ * @version 0.0.0
+ *
+ * Build and run from the repository root:
+ * gcc -std=gnu11 -O2 -pthread -Iinc -IOD -IRobus/inc test/streaming_stress.c src/streaming.c -lm -o streaming_stress && ./streaming_stress
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include "streaming.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define SAMPLE_NB      20000000u
+#define RING_SIZE      256
+#define PUT_CHUNK_MAX  7
+#define GET_CHUNK_MAX  5
+#define WRAP_RING_SIZE 8
+#define REDUCED_NB     200000u
+#define REDUCTION_STEP 1000u
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+uint32_t ring_buffer[RING_SIZE];
+streaming_channel_t stream;
+float reduced_buffer[RING_SIZE];
+streaming_channel_t reduced_stream;
+stream_reducer_t reducer;
+volatile uint8_t reduction_done = false;
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+// Streaming only need an assertion handler
+void Luos_assert(char *file, uint32_t line)
+{
+    printf("assert %s:%u\n", file, (unsigned int)line);
+    exit(1);
+}
+
+/******************************************************************************
+ * @brief producer thread, put increasing values by chunks of 1 to PUT_CHUNK_MAX samples
+ * @param arg unused
+ * @return None
+ ******************************************************************************/
+static void *Stress_Producer(void *arg)
+{
+    uint32_t chunk[PUT_CHUNK_MAX];
+    uint32_t value = 0;
+    (void)arg;
+    while (value < SAMPLE_NB)
+    {
+        uint16_t size = (value % PUT_CHUNK_MAX) + 1;
+        if ((value + size) > SAMPLE_NB)
+        {
+            size = SAMPLE_NB - value;
+        }
+        // Never overwrite unread samples
+        while ((RING_SIZE - Stream_GetAvailableSampleNB(&stream)) < size)
+        {
+            sched_yield();
+        }
+        for (uint16_t i = 0; i < size; i++)
+        {
+            chunk[i] = value + i;
+        }
+        Stream_PutSample(&stream, chunk, size);
+        value += size;
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ * @brief consume all the samples and check they come in order
+ * @return true if no sample have been lost or corrupted
+ ******************************************************************************/
+static uint8_t Stress_Consumer(void)
+{
+    uint32_t chunk[GET_CHUNK_MAX];
+    uint32_t expected = 0;
+    while (expected < SAMPLE_NB)
+    {
+        uint16_t size = (expected % GET_CHUNK_MAX) + 1;
+        if ((expected + size) > SAMPLE_NB)
+        {
+            size = SAMPLE_NB - expected;
+        }
+        if (Stream_GetAvailableSampleNB(&stream) < size)
+        {
+            sched_yield();
+            continue;
+        }
+        Stream_GetSample(&stream, chunk, size);
+        for (uint16_t i = 0; i < size; i++)
+        {
+            if (chunk[i] != expected)
+            {
+                printf("sample %u received instead of %u\n", chunk[i], expected);
+                return false;
+            }
+            expected++;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief check a ring when its 32 bits indexes wrap
+ * @return true if the samples go through the wrap
+ ******************************************************************************/
+static uint8_t Stress_IndexWrap(void)
+{
+    uint16_t buffer[WRAP_RING_SIZE] = {0};
+    uint16_t input[6]               = {1, 2, 3, 4, 5, 6};
+    uint16_t output[6]              = {0};
+    streaming_channel_t wrap_stream = Stream_CreateStreamingChannel(buffer, WRAP_RING_SIZE, sizeof(uint16_t));
+    wrap_stream.head                = 0xFFFFFFFE;
+    wrap_stream.tail                = 0xFFFFFFFE;
+    Stream_PutSample(&wrap_stream, input, 6);
+    if (Stream_GetAvailableSampleNB(&wrap_stream) != 6)
+    {
+        return false;
+    }
+    Stream_GetSample(&wrap_stream, output, 6);
+    if (Stream_GetAvailableSampleNB(&wrap_stream) != 0)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < 6; i++)
+    {
+        if (output[i] != input[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief check a new reduction is applied at the end of the current window
+ * @return true if the window ends with the previous reduction and the next one uses the new reduction
+ ******************************************************************************/
+static uint8_t Stress_ReductionWindow(void)
+{
+    float buffer[WRAP_RING_SIZE];
+    stream_reducer_t window_reducer;
+    const float input[]               = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 9.0f};
+    const stream_reduction_t mean     = {STREAM_MEAN, 4, 0.0f};
+    const stream_reduction_t max      = {STREAM_MAX, 2, 0.0f};
+    float output[2]                   = {0.0f};
+    streaming_channel_t window_stream = Stream_CreateStreamingChannel(buffer, WRAP_RING_SIZE, sizeof(float));
+    Stream_SetReduction(&window_stream, &window_reducer, &mean);
+    Stream_PutSample(&window_stream, &input[0], 2);
+    Stream_SetReduction(&window_stream, &window_reducer, &max);
+    // The mean window end, then the max reduction start
+    if ((Stream_PutSample(&window_stream, &input[2], 2) != 1) || (Stream_PutSample(&window_stream, &input[4], 1) != 1)
+        || (Stream_PutSample(&window_stream, &input[5], 1) != 2))
+    {
+        return false;
+    }
+    Stream_GetSample(&window_stream, output, 2);
+    return (output[0] == 2.5f) && (output[1] == 9.0f);
+}
+
+/******************************************************************************
+ * @brief producer thread, put samples of value 1 to the reduced channel until the consumer is done
+ * @param arg unused
+ * @return None
+ ******************************************************************************/
+static void *Stress_ReducedProducer(void *arg)
+{
+    float chunk[PUT_CHUNK_MAX];
+    uint32_t put_nb = 0;
+    (void)arg;
+    for (uint16_t i = 0; i < PUT_CHUNK_MAX; i++)
+    {
+        chunk[i] = 1.0f;
+    }
+    while (reduction_done == false)
+    {
+        uint16_t size = (put_nb % PUT_CHUNK_MAX) + 1;
+        // A reduced sample never need more room than a put one
+        if ((RING_SIZE - Stream_GetAvailableSampleNB(&reduced_stream)) < size)
+        {
+            sched_yield();
+            continue;
+        }
+        Stream_PutSample(&reduced_stream, chunk, size);
+        put_nb += size;
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ * @brief change the reduction while the producer puts samples and check each reduced sample
+ * Whatever the reduction, a window of samples of value 1 gives 1.
+ * @return true if no reduced sample have been corrupted by a reduction change
+ ******************************************************************************/
+static uint8_t Stress_ReductionChange(void)
+{
+    const stream_reduction_t reductions[] = {{STREAM_MEAN, 3, 0.0f}, {STREAM_MAX, 2, 0.0f}, {STREAM_RMS, 5, 0.0f}, {STREAM_RAW, 1, 0.0f}};
+    pthread_t producer;
+    uint32_t received = 0;
+    float sample      = 0.0f;
+    reduced_stream    = Stream_CreateStreamingChannel(reduced_buffer, RING_SIZE, sizeof(float));
+    Stream_SetReduction(&reduced_stream, &reducer, &reductions[0]);
+    pthread_create(&producer, NULL, Stress_ReducedProducer, NULL);
+    while (received < REDUCED_NB)
+    {
+        if (Stream_GetAvailableSampleNB(&reduced_stream) == 0)
+        {
+            sched_yield();
+            continue;
+        }
+        Stream_GetSample(&reduced_stream, &sample, 1);
+        if (sample != 1.0f)
+        {
+            printf("reduced sample %u is %f\n", received, sample);
+            reduction_done = true;
+            pthread_join(producer, NULL);
+            return false;
+        }
+        received++;
+        if ((received % REDUCTION_STEP) == 0)
+        {
+            Stream_SetReduction(&reduced_stream, &reducer, &reductions[(received / REDUCTION_STEP) % 4]);
+        }
+    }
+    reduction_done = true;
+    pthread_join(producer, NULL);
+    return true;
+}
+
+int main(void)
+{
+    pthread_t producer;
+    if (Stress_IndexWrap() == false)
+    {
+        printf("index wrap failed\n");
+        return 1;
+    }
+    stream = Stream_CreateStreamingChannel(ring_buffer, RING_SIZE, sizeof(uint32_t));
+    pthread_create(&producer, NULL, Stress_Producer, NULL);
+    uint8_t success = Stress_Consumer();
+    pthread_join(producer, NULL);
+    if ((success == false) || (stream.drop_nb != 0))
+    {
+        printf("stress failed, %u samples dropped\n", stream.drop_nb);
+        return 1;
+    }
+    printf("%u samples received in order, head %u tail %u\n", SAMPLE_NB, stream.head, stream.tail);
+    if (Stress_ReductionWindow() == false)
+    {
+        printf("reduction window failed\n");
+        return 1;
+    }
+    if (Stress_ReductionChange() == false)
+    {
+        printf("reduction change failed\n");
+        return 1;
+    }
+    printf("%u reduced samples received while changing the reduction\n", REDUCED_NB);
+    return 0;
+}
@@ -0,0 +1,216 @@
+/******************************************************************************
+ * @file tickless_idle
+ * @brief host comparison of a polled Luos_Loop and a tickless one under a low message rate
+ * @author Luos
+ * @version 0.0.0
+ *
+ * The same 10 s of simulated time run twice : polling Luos_Loop every ms, then sleeping until
+ * Luos_NextEventTick or the next received message. Both runs must manage the same messages and
+ * timer calls on time, the tickless one with far less Luos_Loop calls.
+ * A batch container keeping messages until it has BATCH_SIZE of them must not keep the node awake.
+ * Build and run from the repository root, with all the Luos and Robus sources:
+ * gcc -std=gnu11 -O2 -no-pie -Itest -Iinc -IOD -IRobus/inc test/tickless_idle.c test/luos_hal.c src/[a-z]*.c Robus/src/[a-z]*.c -lm -o tickless_idle && ./tickless_idle
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "luos.h"
+#include "luos_hal.h"
+#include "msg_alloc.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define SIMULATION_MS   10000
+#define TIMER_MS        50
+#define MSG_PERIOD_MS   100
+#define BATCH_PERIOD_MS 30
+#define BATCH_SIZE      4
+#define MAX_LOOP_NB     (4 * SIMULATION_MS)
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+container_t *app_container;
+container_t *batch_container;
+luos_timer_t timer;
+uint32_t timer_nb     = 0;
+uint32_t timer_late   = 0;
+uint32_t msg_nb       = 0;
+uint32_t msg_late     = 0;
+uint32_t batch_msg_nb = 0;
+
+/*******************************************************************************
+ * Function
+ ******************************************************************************/
+static double Idle_CpuTime(void)
+{
+    struct timespec date;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &date);
+    return date.tv_sec * 1e3 + date.tv_nsec / 1e6;
+}
+
+static void Idle_Timer(container_t *container, luos_timer_t *timer)
+{
+    (void)container;
+    (void)timer;
+    timer_nb++;
+    if (hal_tick != (timer_nb * TIMER_MS))
+    {
+        timer_late++;
+    }
+}
+
+static void Idle_Callback(container_t *container, msg_t *msg)
+{
+    (void)container;
+    uint32_t date = 0;
+    memcpy(&date, msg->data, sizeof(date));
+    msg_nb++;
+    if (hal_tick != date)
+    {
+        msg_late++;
+    }
+}
+
+static uint16_t Idle_BatchCallback(container_t *container, msg_t **msg, uint16_t nb)
+{
+    (void)container;
+    (void)msg;
+    if (nb < BATCH_SIZE)
+    {
+        // Wait for a complete batch
+        return 0;
+    }
+    batch_msg_nb += nb;
+    return nb;
+}
+
+/******************************************************************************
+ * @brief give a message to the reception allocator like the bus reception does
+ * @param container targeted
+ * @return None
+ ******************************************************************************/
+static void Idle_Receive(container_t *container)
+{
+    header_t header    = {0};
+    uint32_t date      = hal_tick;
+    header.target      = container->ll_container->id;
+    header.target_mode = ID;
+    header.source      = 1;
+    header.cmd         = LINEAR_POSITION;
+    header.size        = sizeof(date);
+    for (uint8_t i = 0; i < sizeof(header_t); i++)
+    {
+        MsgAlloc_SetData(header.unmap[i]);
+    }
+    MsgAlloc_ValidHeader(true, header.size);
+    for (uint8_t i = 0; i < sizeof(date); i++)
+    {
+        MsgAlloc_SetData(((uint8_t *)&date)[i]);
+    }
+    // CRC
+    MsgAlloc_SetData(0);
+    MsgAlloc_SetData(0);
+    MsgAlloc_EndMsg();
+}
+
+/******************************************************************************
+ * @brief receive the messages of the current date
+ * @return date of the next message
+ ******************************************************************************/
+static uint32_t Idle_ReceiveMessages(void)
+{
+    if ((hal_tick % MSG_PERIOD_MS) == 0)
+    {
+        Idle_Receive(app_container);
+    }
+    if ((hal_tick % BATCH_PERIOD_MS) == 0)
+    {
+        Idle_Receive(batch_container);
+    }
+    uint32_t next_msg   = (hal_tick / MSG_PERIOD_MS + 1) * MSG_PERIOD_MS;
+    uint32_t next_batch = (hal_tick / BATCH_PERIOD_MS + 1) * BATCH_PERIOD_MS;
+    return (next_msg < next_batch) ? next_msg : next_batch;
+}
+
+/******************************************************************************
+ * @brief run SIMULATION_MS of simulated time
+ * @param tickless sleep until the next event instead of polling each ms
+ * @param loop_nb filled with the number of Luos_Loop calls
+ * @return CPU time used in ms
+ ******************************************************************************/
+static double Idle_Run(uint8_t tickless, uint32_t *loop_nb)
+{
+    revision_t revision = {0};
+    hal_tick            = 0;
+    timer_nb            = 0;
+    timer_late          = 0;
+    msg_nb              = 0;
+    msg_late            = 0;
+    batch_msg_nb        = 0;
+    *loop_nb            = 0;
+    Luos_Init();
+    app_container   = Luos_CreateContainer(Idle_Callback, VOID_MOD, "app", revision);
+    batch_container = Luos_CreateContainer(0, VOID_MOD, "batch", revision);
+    Luos_SetBatchCallback(batch_container, Idle_BatchCallback);
+    // No detection on the host, give the IDs
+    app_container->ll_container->id   = 1;
+    batch_container->ll_container->id = 2;
+    Luos_TimerStart(app_container, &timer, TIMER_MS, TIMER_MS, Idle_Timer);
+
+    double start = Idle_CpuTime();
+    while ((hal_tick < SIMULATION_MS) && (*loop_nb < MAX_LOOP_NB))
+    {
+        uint32_t next_msg = Idle_ReceiveMessages();
+        Luos_Loop();
+        (*loop_nb)++;
+        if (tickless == false)
+        {
+            hal_tick++;
+            continue;
+        }
+        // Sleep until the next event or the next message reception wake us up
+        uint32_t next = Luos_NextEventTick();
+        if (next == hal_tick)
+        {
+            // Luos_Loop still have something to do, loop again without moving the time
+            while ((next == hal_tick) && (*loop_nb < MAX_LOOP_NB))
+            {
+                Luos_Loop();
+                (*loop_nb)++;
+                next = Luos_NextEventTick();
+            }
+        }
+        hal_tick = ((int32_t)(next - next_msg) < 0) ? next : next_msg;
+    }
+    Luos_TimerStop(&timer);
+    return Idle_CpuTime() - start;
+}
+
+int main(void)
+{
+    uint32_t polled_loop_nb   = 0;
+    uint32_t tickless_loop_nb = 0;
+    double polled_time        = Idle_Run(false, &polled_loop_nb);
+    uint32_t polled_timer_nb  = timer_nb;
+    uint32_t polled_msg_nb    = msg_nb;
+    uint32_t polled_batch_nb  = batch_msg_nb;
+    double tickless_time      = Idle_Run(true, &tickless_loop_nb);
+    printf("polled   : %u loops, %.2f ms CPU, %u timer calls, %u messages, %u batched\n",
+           polled_loop_nb, polled_time, polled_timer_nb, polled_msg_nb, polled_batch_nb);
+    printf("tickless : %u loops, %.2f ms CPU, %u timer calls, %u messages, %u batched\n",
+           tickless_loop_nb, tickless_time, timer_nb, msg_nb, batch_msg_nb);
+    if ((tickless_loop_nb >= MAX_LOOP_NB) || (timer_nb != polled_timer_nb) || (msg_nb != polled_msg_nb)
+        || (batch_msg_nb != polled_batch_nb) || (timer_late != 0) || (msg_late != 0))
+    {
+        printf("tickless run failed, %u late timer calls, %u late messages\n", timer_late, msg_late);
+        return 1;
+    }
+    if ((tickless_loop_nb * 10) > polled_loop_nb)
+    {
+        printf("tickless run didn't sleep\n");
+        return 1;
+    }
+    return 0;
+}